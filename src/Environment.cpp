@@ -1,9 +1,34 @@
 #include "Environment.h"
 
 #include "util/Maths.h"
+#include "util/Preprocessing.h"
 
 using namespace PLANS;
 
+//############################ Environment ############################
+
+void Environment::getInputDataBatch(uint32_t numOfAgents, std::vector<float>& data) {
+	agentInputData.resize(LSTM_INPUT_SIZE);
+	for(AGENT_ID agentID = 0; agentID < numOfAgents; agentID++) {
+		getInputData(agentID, agentInputData);
+		std::copy(agentInputData.begin(), agentInputData.end(), data.begin() + agentID * LSTM_INPUT_SIZE);
+	}
+}
+
+void Environment::onActions(const std::vector<AGENT_ID>& agentIDs, const std::vector<float>& actions) {
+	for(size_t i = 0; i < agentIDs.size(); i++) {
+		onAction(agentIDs[i], actions[i]);
+	}
+}
+
+bool Environment::agentGameOver(AGENT_ID agentID) {
+	return false;
+}
+
+uint32_t Environment::getObservationSize() {
+	return static_cast<uint32_t>(LSTM_INPUT_SIZE);
+}
+
 //############################ EnvironmentBinary ############################
 
 EnvironmentBinary::EnvironmentBinary() : Environment(), random(), state(), actions() {}
@@ -104,14 +129,19 @@ bool EnvironmentFloat::gameOver() {
 
 //############################ EnvironmentBreakout ############################
 
-EnvironmentBreakout::EnvironmentBreakout() : ale(), reward() {
+// Selected values of the ram. Source: https://www.codeproject.com/Articles/5271949/Learning-Breakout-From-RAM-Part-1
+static const uint32_t BREAKOUT_NUM_OF_RAM_VALUES = 13;
+static const uint32_t BREAKOUT_RAM_VALUES_INDICES[BREAKOUT_NUM_OF_RAM_VALUES] = {70, 71, 72, 74, 75, 90, 94, 95, 99, 101, 103, 105, 119};
+
+EnvironmentBreakout::EnvironmentBreakout(uint32_t startStatePoolSize, uint32_t maxStartNoOps) : ale(), legal_actions(), reward(), random(), startStates() {
 	// Prepare interface. 
-	ale.setInt("random_seed", Random().nextIntInRange(1, 123));
+	ale.setInt("random_seed", random.nextIntInRange(1, 123));
 	ale.setFloat("repeat_action_probability", 0.0F);
 	ale.loadROM("./roms/Breakout.bin");
 	// Get the vector of legal actions. 
 	legal_actions = ale.getMinimalActionSet();
 	ale.lives();
+	createStartStates(startStatePoolSize, maxStartNoOps);
 }
 
 uint32_t EnvironmentBreakout::maxNumOfAgents() {
@@ -123,8 +153,13 @@ bool EnvironmentBreakout::onlyFinalReward() {
 }
 
 void EnvironmentBreakout::reset(uint32_t numOfAgents) {
+	if(!startStates.empty()) {
+		// Restoring is much cheaper than replaying the startup frames. 
+		ale.restoreState(startStates[random.nextUInt(static_cast<uint32_t>(startStates.size()))]);
+		return;
+	}
 	ale.reset_game();
-	ale.setInt("random_seed", Random().nextIntInRange(1, 123));
+	ale.setInt("random_seed", random.nextIntInRange(1, 123));
 }
 
 void EnvironmentBreakout::update() {}
@@ -133,27 +168,17 @@ void EnvironmentBreakout::getInputData(AGENT_ID agentID, std::vector<float>& dat
 	const ale::ALEScreen& screen = ale.getScreen();
 	const ale::ALERAM& ram = ale.getRAM();
 
-	//ale::ALEState state = ale.cloneState();
-	//size_t arraySize = screen.arraySize();
-	//ale::pixel_t* array = screen.getArray();
-	//for(size_t i = 0; i < arraySize; i++) {
-	//	data.push_back(static_cast<ale::pixel_t>(array[i]));
-	//}
+	// The kernels of AEX::Preprocessing write into "data" directly. 
+
+	//// Give the downsampled grayscale screen as input (LSTM_INPUT_SIZE = 105 * 80). "screenData" would be a member, to not allocate every step. 
+	//ale.getScreenGrayscale(screenData);
+	//AEX::Preprocessing::downsample(screenData.data(), static_cast<uint32_t>(screen.width()), static_cast<uint32_t>(screen.height()), data.data(), 1.0F / 255.0F);
 	
-	//// Give whole ram as input. 
-	//size_t arraySize = ram.size();
-	//const ale::byte_t* array = ram.array();
-	//for(size_t i = 0; i < arraySize; i++) {
-	//	data.push_back(static_cast<ale::byte_t>(array[i]));
-	//}
-
-	// Give selected values of the ram as input. Source: https://www.codeproject.com/Articles/5271949/Learning-Breakout-From-RAM-Part-1
-	int numOfValues = 13;
-	int valuesIndices[13] = {70, 71, 72, 74, 75, 90, 94, 95, 99, 101, 103, 105, 119};
-	// Gahter values. 
-	for(size_t i = 0; i < numOfValues; i++) {
-		data.push_back(ram.array()[valuesIndices[i]]);
-	}
+	//// Give whole ram as input (LSTM_INPUT_SIZE = 128). 
+	//AEX::Preprocessing::convert(ram.array(), data.data(), ram.size());
+
+	// Give selected values of the ram as input. 
+	AEX::Preprocessing::gather(ram.array(), ram.size(), BREAKOUT_RAM_VALUES_INDICES, data.data(), BREAKOUT_NUM_OF_RAM_VALUES);
 
 }
 
@@ -176,3 +201,25 @@ float EnvironmentBreakout::rewardAgent(AGENT_ID agentID) {
 bool EnvironmentBreakout::gameOver() {
 	return ale.game_over();
 }
+
+uint32_t EnvironmentBreakout::getObservationSize() {
+	return BREAKOUT_NUM_OF_RAM_VALUES;
+}
+
+void EnvironmentBreakout::createStartStates(uint32_t startStatePoolSize, uint32_t maxStartNoOps) {
+	if(startStatePoolSize == 0) {
+		return;
+	}
+	// "loadROM" reset the game already, so this is the state after the startup frames. 
+	ale::ALEState initialState = ale.cloneState();
+	startStates.reserve(startStatePoolSize);
+	for(uint32_t i = 0; i < startStatePoolSize; i++) {
+		ale.restoreState(initialState);
+		uint32_t numOfNoOps = random.nextUInt(maxStartNoOps + 1);
+		for(uint32_t j = 0; j < numOfNoOps && !ale.game_over(); j++) {
+			ale.act(ale::PLAYER_A_NOOP);
+		}
+		startStates.push_back(ale.cloneState());
+	}
+	ale.restoreState(initialState);
+}
@@ -8,6 +8,7 @@ namespace PLANS {
 	class Environment {
 		public:
 			Environment() = default;
+			virtual ~Environment() = default;
 
 			virtual uint32_t maxNumOfAgents() = 0;
 			virtual bool onlyFinalReward() = 0;		// Whether the environment only rewards once per episode (at the last act) or continuously. 
@@ -18,12 +19,21 @@ namespace PLANS {
 			virtual void onAction(AGENT_ID agentID, float action) = 0;
 			virtual float rewardAgent(AGENT_ID agentID) = 0;
 			virtual bool gameOver() = 0;
+			// Writes the input data of the first "numOfAgents" agents into "data" as one row of LSTM_INPUT_SIZE values per agent. 
+			virtual void getInputDataBatch(uint32_t numOfAgents, std::vector<float>& data);
+			// Executes "actions[i]" for the agent "agentIDs[i]". Environments with independent instances may step them concurrently (see VectorEnvironment). 
+			virtual void onActions(const std::vector<AGENT_ID>& agentIDs, const std::vector<float>& actions);
+			// Whether the environment instance of the given agent reached game over on its own. Only environments that reset single instances automatically (see VectorEnvironment) return true here. 
+			virtual bool agentGameOver(AGENT_ID agentID);
+			// How many values "getInputData" writes. LSTM_INPUT_SIZE, unless the input is assembled from multiple observations (see FrameSkipEnvironment). 
+			virtual uint32_t getObservationSize();
 		protected:
 			template<typename T>
 			static void putIntoData(std::vector<float>& dataVector, int& currentIndex, T value) {
 				dataVector[currentIndex++] = static_cast<float>(value);
 			}
 		private:
+			std::vector<float> agentInputData;	// Scratch buffer of "getInputDataBatch", reused every step. 
 	};
 
 	//############################ EnvironmentBinary ############################
@@ -75,10 +85,12 @@ namespace PLANS {
 	*	Atari Breakout environment. 
 	*		- Rewards are only given when the episode is game over (all lives gone). 
 	*		- The reward equals the total score. 
+	*		- If "startStatePoolSize" is greater than 0, resets restore a random one of that many start states instead of resetting the game, which replays the startup frames of the ROM. 
+	*		  The start states are cloned once at construction, each after a random number of no-op frames in [0, maxStartNoOps]. 
 	*/
 	class EnvironmentBreakout : public Environment {
 		public:
-			EnvironmentBreakout();
+			explicit EnvironmentBreakout(uint32_t startStatePoolSize = 0, uint32_t maxStartNoOps = 0);
 
 			virtual uint32_t maxNumOfAgents() final override;
 			virtual bool onlyFinalReward() final override;
@@ -89,11 +101,16 @@ namespace PLANS {
 			virtual void onAction(AGENT_ID agentID, float action) final override;
 			virtual float rewardAgent(AGENT_ID agentID) final override;
 			virtual bool gameOver() final override;
+			virtual uint32_t getObservationSize() final override;
 		protected:
 		private:
 			ale::ALEInterface ale;
 			ale::ActionVect legal_actions;
 			float reward;
+			Random random;
+			std::vector<ale::ALEState> startStates;
+
+			void createStartStates(uint32_t startStatePoolSize, uint32_t maxStartNoOps);
 	};
 
 }
@@ -0,0 +1,144 @@
+#include "FastActorCritic.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace PLANS;
+using namespace AEX;
+
+// Layers of ActorCriticImpl in the order of ActorCriticImpl::forward. 
+struct LayerSpec {
+	const char* name;
+	FastActorCritic::Activation activation;
+};
+static const std::vector<LayerSpec> ACTOR_LAYERS = { { "a_lin1", FastActorCritic::Activation::RELU }, { "a_lin2", FastActorCritic::Activation::RELU }, { "a_lin3", FastActorCritic::Activation::TANH } };
+static const std::vector<LayerSpec> CRITIC_LAYERS = { { "c_lin1", FastActorCritic::Activation::RELU }, { "c_lin2", FastActorCritic::Activation::RELU }, { "c_lin3", FastActorCritic::Activation::TANH }, { "c_val", FastActorCritic::Activation::NONE } };
+
+static const uint32_t ROW_ALIGNMENT = 8;		// Floats per AVX register, AEX::SIMD::dot needs row lengths of multiples of it. 
+static const uint32_t LAYER_ALIGNMENT = 16;		// Floats per cache line. 
+
+static uint32_t roundUp(uint32_t value, uint32_t multiple) {
+	return (value + multiple - 1) / multiple * multiple;
+}
+
+//############################ FastActorCritic ############################
+
+// PUBLIC
+
+FastActorCritic::FastActorCritic() : level(SIMD::getDetectedLevel()), storage(), data(nullptr), actorLayers(), criticLayers(), logStd(), actorMean(LSTM_OUTPUT_SIZE), activations(), activationStride(0), generator(std::random_device()()), normalDistribution(0.0F, 1.0F), valid(false) {}
+
+bool FastActorCritic::snapshot(torch::nn::Module& model) {
+	torch::NoGradGuard noGrad;
+	valid = false;
+	actorLayers.clear();
+	criticLayers.clear();
+
+	// Collect the layers, each with its weights and bias (as contiguous float CPU tensors). 
+	torch::OrderedDict<std::string, torch::Tensor> parameters = model.named_parameters();
+	std::vector<std::pair<torch::Tensor, torch::Tensor>> tensors;
+	size_t size = 0;
+	activationStride = roundUp(static_cast<uint32_t>(LSTM_INPUT_SIZE), ROW_ALIGNMENT);
+	for(const std::vector<LayerSpec>* specs : { &ACTOR_LAYERS, &CRITIC_LAYERS }) {
+		std::vector<Layer>& layers = specs == &ACTOR_LAYERS ? actorLayers : criticLayers;
+		uint32_t numOfInputs = static_cast<uint32_t>(LSTM_INPUT_SIZE);
+		for(const LayerSpec& spec : *specs) {
+			const torch::Tensor* weights = parameters.find(std::string(spec.name) + ".weight");
+			const torch::Tensor* bias = parameters.find(std::string(spec.name) + ".bias");
+			if(weights == nullptr || bias == nullptr || weights->dim() != 2 || weights->size(1) != numOfInputs || bias->numel() != weights->size(0)) {
+				return false;	// Not an ActorCriticImpl. 
+			}
+			Layer layer = Layer();
+			layer.numOfInputs = numOfInputs;
+			layer.numOfOutputs = static_cast<uint32_t>(weights->size(0));
+			layer.rowStride = roundUp(layer.numOfInputs, ROW_ALIGNMENT);
+			layer.weightsOffset = size;
+			size += roundUp(layer.numOfOutputs * layer.rowStride, LAYER_ALIGNMENT);
+			layer.biasOffset = size;
+			size += roundUp(layer.numOfOutputs, LAYER_ALIGNMENT);
+			layer.activation = spec.activation;
+			layers.push_back(layer);
+			tensors.emplace_back(weights->detach().to(torch::kCPU, torch::kFloat32).contiguous(), bias->detach().to(torch::kCPU, torch::kFloat32).contiguous());
+			activationStride = std::max(activationStride, roundUp(layer.numOfOutputs, ROW_ALIGNMENT));
+			numOfInputs = layer.numOfOutputs;
+		}
+	}
+	const torch::Tensor* logStdTensor = parameters.find("log_std");
+	if(actorLayers.back().numOfOutputs != LSTM_OUTPUT_SIZE || criticLayers.back().numOfOutputs != 1 || logStdTensor == nullptr || logStdTensor->numel() != LSTM_OUTPUT_SIZE) {
+		return false;
+	}
+
+	// Copy the weights row by row into the padded layout. 
+	storage.assign(size + LAYER_ALIGNMENT, 0.0F);
+	size_t misalignment = (reinterpret_cast<uintptr_t>(storage.data()) / sizeof(float)) % LAYER_ALIGNMENT;
+	data = storage.data() + (LAYER_ALIGNMENT - misalignment) % LAYER_ALIGNMENT;
+	size_t tensorIndex = 0;
+	for(const std::vector<Layer>* layers : { &actorLayers, &criticLayers }) {
+		for(const Layer& layer : *layers) {
+			const float* weights = tensors[tensorIndex].first.data_ptr<float>();
+			const float* bias = tensors[tensorIndex].second.data_ptr<float>();
+			for(uint32_t o = 0; o < layer.numOfOutputs; o++) {
+				std::copy(weights + static_cast<size_t>(o) * layer.numOfInputs, weights + static_cast<size_t>(o + 1) * layer.numOfInputs, data + layer.weightsOffset + static_cast<size_t>(o) * layer.rowStride);
+			}
+			std::copy(bias, bias + layer.numOfOutputs, data + layer.biasOffset);
+			tensorIndex++;
+		}
+	}
+	torch::Tensor logStdCPU = logStdTensor->detach().to(torch::kCPU, torch::kFloat32).contiguous();
+	logStd.assign(logStdCPU.data_ptr<float>(), logStdCPU.data_ptr<float>() + LSTM_OUTPUT_SIZE);
+	activations.assign(static_cast<size_t>(activationStride) * 2, 0.0F);
+
+	valid = true;
+	return true;
+}
+
+bool FastActorCritic::isValid() const {
+	return valid;
+}
+
+void FastActorCritic::act(const float* input, float* action, float* logProb, float& value) {
+	// The activation buffers are reused by the critic, so the actor output is copied. 
+	const float* mean = runLayers(actorLayers, input);
+	std::copy(mean, mean + LSTM_OUTPUT_SIZE, actorMean.begin());
+	value = runLayers(criticLayers, input)[0];
+
+	// Sample the action and calculate its logProb (see ActorCriticImpl::forward and ActorCriticImpl::logProb). 
+	for(int64_t i = 0; i < LSTM_OUTPUT_SIZE; i++) {
+		float standardDeviation = std::exp(logStd[i]);
+		action[i] = actorMean[i] + standardDeviation * normalDistribution(generator);
+		float difference = action[i] - actorMean[i];
+		logProb[i] = -(difference * difference) / (2.0F * standardDeviation * standardDeviation) - logStd[i] - static_cast<float>(std::log(std::sqrt(2.0 * M_PI)));
+	}
+}
+
+// PRIVATE
+
+const float* FastActorCritic::runLayers(const std::vector<Layer>& layers, const float* input) {
+	float* buffers[2] = { activations.data(), activations.data() + activationStride };
+	std::copy(input, input + LSTM_INPUT_SIZE, buffers[0]);
+	std::fill(buffers[0] + LSTM_INPUT_SIZE, buffers[0] + roundUp(static_cast<uint32_t>(LSTM_INPUT_SIZE), ROW_ALIGNMENT), 0.0F);
+	for(size_t i = 0; i < layers.size(); i++) {
+		runLayer(layers[i], buffers[i % 2], buffers[(i + 1) % 2]);
+	}
+	return buffers[layers.size() % 2];
+}
+
+void FastActorCritic::runLayer(const Layer& layer, const float* input, float* output) const {
+	const float* weights = data + layer.weightsOffset;
+	const float* bias = data + layer.biasOffset;
+	for(uint32_t o = 0; o < layer.numOfOutputs; o++) {
+		float sum = SIMD::dot(level, weights + static_cast<size_t>(o) * layer.rowStride, input, layer.rowStride) + bias[o];
+		switch(layer.activation) {
+			case Activation::RELU:
+				output[o] = std::max(sum, 0.0F);
+				break;
+			case Activation::TANH:
+				output[o] = std::tanh(sum);
+				break;
+			default:
+				output[o] = sum;
+				break;
+		}
+	}
+	// Keep the padding zero, as the next layer reads whole rows. 
+	std::fill(output + layer.numOfOutputs, output + roundUp(layer.numOfOutputs, ROW_ALIGNMENT), 0.0F);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <random>
+
+#include "Models.h"
+#include "util/SIMD.h"
+
+namespace PLANS {
+
+	//############################ FastActorCritic ############################
+
+	/*
+	*	Inference-only evaluator of an ActorCriticImpl on the CPU, used by the actors instead of the torch module (see TrainingController::runPolicies). 
+	*		- "snapshot" copies the weights into one buffer. Every layer starts at a cache line, its rows are padded to multiples of 8 floats. 
+	*		- Each layer is a GEMV fused with its activation, vectorized via AVX2 or SSE (see AEX::SIMD), no tensors or dispatching involved. 
+	*		- Actions are sampled from the normal distribution around the actor output, like ActorCriticImpl::forward does. 
+	*		- The snapshot has to be refreshed whenever the weights of the model change (see TrainingController::publishPolicy). 
+	*/
+	class FastActorCritic {
+		public:
+			enum class Activation : uint8_t {
+				NONE,
+				RELU,
+				TANH
+			};
+
+			FastActorCritic();
+
+			// Copies the weights of the given model. Returns false, if the model doesn't have the layers of an ActorCriticImpl. The evaluator is invalid then. 
+			bool snapshot(torch::nn::Module& model);
+			bool isValid() const;
+			// Evaluates the model for a single input of LSTM_INPUT_SIZE values. Writes the sampled action and its logProb (LSTM_OUTPUT_SIZE values each) and the value of the critic. 
+			void act(const float* input, float* action, float* logProb, float& value);
+		protected:
+		private:
+			struct Layer {
+				uint32_t numOfInputs;
+				uint32_t numOfOutputs;
+				uint32_t rowStride;		// Row length in floats, padded. 
+				size_t weightsOffset;	// Offsets in "data". 
+				size_t biasOffset;
+				Activation activation;
+			};
+
+			AEX::SIMDLevel level;
+			std::vector<float> storage;		// Over allocated, so "data" starts at a cache line. 
+			float* data;
+			std::vector<Layer> actorLayers;
+			std::vector<Layer> criticLayers;
+			std::vector<float> logStd;
+			std::vector<float> actorMean;
+			std::vector<float> activations;	// Two padded activation buffers of "activationStride" floats. 
+			uint32_t activationStride;
+			std::mt19937 generator;
+			std::normal_distribution<float> normalDistribution;
+			bool valid;
+
+			// Runs the given layers. Returns the output of the last layer. 
+			const float* runLayers(const std::vector<Layer>& layers, const float* input);
+			void runLayer(const Layer& layer, const float* input, float* output) const;
+	};
+
+}
@@ -0,0 +1,110 @@
+#include "FrameSkipEnvironment.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "util/Maths.h"
+
+using namespace PLANS;
+
+//############################ FrameSkipEnvironment ############################
+
+// PUBLIC
+
+FrameSkipEnvironment::FrameSkipEnvironment(Environment* environment, uint32_t frameSkip, bool frameMaxPool, uint32_t frameStack) : Environment(), environment(environment), frameSkip(Maths::max<uint32_t>(frameSkip, 1)), frameMaxPool(frameMaxPool), frameStack(Maths::max<uint32_t>(frameStack, 1)), observationSize(0), frames(), newestFrame(0), observationData(), previousObservation(), reward(0.0F) {
+	// The stacked observations have to fill the input exactly. The buffers are sized by the observations the decorated environment actually writes. 
+	observationSize = environment->getObservationSize();
+	if(static_cast<int64_t>(observationSize) * this->frameStack != LSTM_INPUT_SIZE) {
+		std::cerr << ("FrameSkipEnvironment: The observation size (" + std::to_string(observationSize) + ") times frameStack (" + std::to_string(this->frameStack) + ") doesn't equal LSTM_INPUT_SIZE (" + std::to_string(LSTM_INPUT_SIZE) + ").") << std::endl;
+		abort();
+	}
+	frames = std::vector<float>(static_cast<size_t>(observationSize) * this->frameStack);
+	observationData = std::vector<float>(observationSize);
+	previousObservation = std::vector<float>(observationSize);
+}
+
+FrameSkipEnvironment::~FrameSkipEnvironment() {
+	delete environment;
+}
+
+uint32_t FrameSkipEnvironment::maxNumOfAgents() {
+	return 1;
+}
+
+bool FrameSkipEnvironment::onlyFinalReward() {
+	return environment->onlyFinalReward();
+}
+
+void FrameSkipEnvironment::reset(uint32_t numOfAgents) {
+	environment->reset(1);
+	reward = 0.0F;
+	// Fill the whole stack with the first observation. 
+	float* observation = pushObservation();
+	for(uint32_t i = 0; i < frameStack; i++) {
+		if(i != newestFrame) {
+			std::copy(observation, observation + observationSize, frames.begin() + static_cast<size_t>(i) * observationSize);
+		}
+	}
+}
+
+void FrameSkipEnvironment::update() {
+	environment->update();
+}
+
+void FrameSkipEnvironment::getInputData(AGENT_ID agentID, std::vector<float>& data) {
+	// Oldest observation first. 
+	for(uint32_t i = 0; i < frameStack; i++) {
+		uint32_t frame = (newestFrame + 1 + i) % frameStack;
+		std::copy(frames.begin() + static_cast<size_t>(frame) * observationSize, frames.begin() + static_cast<size_t>(frame + 1) * observationSize, data.begin() + static_cast<size_t>(i) * observationSize);
+	}
+}
+
+float FrameSkipEnvironment::getActionMax() {
+	return environment->getActionMax();
+}
+
+void FrameSkipEnvironment::onAction(AGENT_ID agentID, float action) {
+	reward = 0.0F;
+	bool pool = false;
+	for(uint32_t i = 0; i < frameSkip; i++) {
+		// The observation before the last repetition is the second last frame. 
+		if(frameMaxPool && i > 0 && i == frameSkip - 1) {
+			environment->getInputData(0, previousObservation);
+			pool = true;
+		}
+		environment->onAction(0, action);
+		reward += environment->rewardAgent(0);
+		if(environment->gameOver()) {
+			break;
+		}
+	}
+	float* observation = pushObservation();
+	if(pool) {
+		for(uint32_t i = 0; i < observationSize; i++) {
+			observation[i] = Maths::max(observation[i], previousObservation[i]);
+		}
+	}
+}
+
+float FrameSkipEnvironment::rewardAgent(AGENT_ID agentID) {
+	return reward;
+}
+
+bool FrameSkipEnvironment::gameOver() {
+	return environment->gameOver();
+}
+
+uint32_t FrameSkipEnvironment::getObservationSize() {
+	return observationSize * frameStack;
+}
+
+// PRIVATE
+
+float* FrameSkipEnvironment::pushObservation() {
+	newestFrame = (newestFrame + 1) % frameStack;
+	float* observation = frames.data() + static_cast<size_t>(newestFrame) * observationSize;
+	// The decorated environment writes into a vector, so the scratch buffer is used and copied. 
+	environment->getInputData(0, observationData);
+	std::copy(observationData.begin(), observationData.end(), observation);
+	return observation;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Environment.h"
+
+namespace PLANS {
+
+	//############################ FrameSkipEnvironment ############################
+
+	/*
+	*	Decorator of a single-agent environment (e.g. EnvironmentBreakout), which lets the agent decide only every "frameSkip" frames. 
+	*		- An action is repeated "frameSkip" times, the rewards of the repetitions are summed up. Repeating stops early once the environment is game over. 
+	*		- If "frameMaxPool" is set, the observation is the element-wise maximum of the observations of the last two frames (removes flickering objects). 
+	*		- The input data consists of the last "frameStack" observations, oldest first. Each observation has the observation size of the decorated environment, which times "frameStack" has to equal LSTM_INPUT_SIZE. After a reset, all stacked observations equal the first one. 
+	*		- Takes ownership of the decorated environment. 
+	*/
+	class FrameSkipEnvironment : public Environment {
+		public:
+			FrameSkipEnvironment(Environment* environment, uint32_t frameSkip, bool frameMaxPool, uint32_t frameStack);
+			virtual ~FrameSkipEnvironment();
+
+			virtual uint32_t maxNumOfAgents() final override;
+			virtual bool onlyFinalReward() final override;
+			virtual void reset(uint32_t numOfAgents) final override;
+			virtual void update() final override;
+			virtual void getInputData(AGENT_ID agentID, std::vector<float>& data) final override;
+			virtual float getActionMax() final override;
+			virtual void onAction(AGENT_ID agentID, float action) final override;
+			virtual float rewardAgent(AGENT_ID agentID) final override;
+			virtual bool gameOver() final override;
+			virtual uint32_t getObservationSize() final override;
+		protected:
+		private:
+			Environment* environment;
+			uint32_t frameSkip;
+			bool frameMaxPool;
+			uint32_t frameStack;
+			uint32_t observationSize;				// Observation size of the decorated environment. 
+			std::vector<float> frames;				// Ring buffer of the last "frameStack" observations. 
+			uint32_t newestFrame;					// Index of the newest observation in "frames". 
+			std::vector<float> observationData;		// Scratch buffer for the observations of the decorated environment. 
+			std::vector<float> previousObservation;	// Observation before the last repetition, for max pooling. 
+			float reward;							// Sum of the rewards of the last action. 
+
+			// Fetches the current observation of the decorated environment into the next frame of the ring buffer. 
+			float* pushObservation();
+	};
+
+}
@@ -1,9 +1,13 @@
 #include "TrainingConsts.h"
 #include "Environment.h"
+#include "VectorEnvironment.h"
+#include "FrameSkipEnvironment.h"
 #include "TrainingParser.h"
 #include "trainingController/TrainingController.h"
 #include "trainingController/TrainingControllerContinuous.h"
 #include "trainingController/TrainingControllerEpisodic.h"
+#include "trainingController/DeltaCheckpoint.h"
+#include "trainingController/ScriptedPolicy.h"
 #include "TrainingLogger.h"
 #include "TrainingEncoder.h"
 #include "util/Maths.h"
@@ -17,16 +21,71 @@ int main(int argc, const char** argv) {
 	at::globalContext().setAllowTF32CuDNN(true);
 	at::globalContext().setDeterministicCuDNN(true);
 
+	// Reconstruct a full checkpoint from a delta checkpoint: "--reconstruct <delta checkpoint> <target file>". 
+	if(argc == 4 && std::string(argv[1]) == "--reconstruct") {
+		DeltaCheckpoint::reconstruct(argv[2], argv[3]);
+		return 0;
+	}
+
 	// Parse training parameters. 
 	TrainingParameters* parameters = new TrainingParameters();
 	TrainingParser::parseConfigFile("./trainingConfig.json", parameters);
 	
 	// Init environment. 
 	//Environment* enviroment = new EnvironmentBinary();
-	Environment* enviroment = new EnvironmentBreakout();
+	// Every instance is decorated on its own, so frames are skipped per instance. 
+	VectorEnvironment::EnvironmentFactory environmentFactory = [parameters]() -> Environment* {
+		Environment* environment = new EnvironmentBreakout(parameters->startStatePoolSize, parameters->maxStartNoOps);
+		if(parameters->frameSkip > 1 || parameters->frameStack > 1) {
+			return new FrameSkipEnvironment(environment, parameters->frameSkip, parameters->frameMaxPool, parameters->frameStack);
+		}
+		return environment;
+	};
+
+	// Evaluate an exported policy (see ScriptedPolicy): "--evaluate <scripted policy> <num of episodes>". Played by a single agent, nothing is trained. 
+	if(argc == 4 && std::string(argv[1]) == "--evaluate") {
+		// The policy runs on the device it has been exported on, which is the training device (see CheckpointWriter::exportPolicies). 
+#ifdef USE_CUDA
+		torch::Device device = torch::kCUDA;
+#else
+		torch::Device device = torch::kCPU;
+#endif
+		ScriptedPolicy policy = ScriptedPolicy(argv[2], device);
+		uint32_t numOfEpisodes = static_cast<uint32_t>(std::stoul(argv[3]));
+		Environment* environment = environmentFactory();
+		std::vector<float> inputData = std::vector<float>(LSTM_INPUT_SIZE);
+		torch::Tensor inputTensor = torch::from_blob(inputData.data(), { 1, LSTM_INPUT_SIZE }, torch::TensorOptions().dtype(torch::kFloat32));
+		torch::Tensor state = torch::empty({ 1, LSTM_INPUT_SIZE }, torch::TensorOptions().dtype(torch::kFloat32));
+		// The encoder copies the input to the device of the policy (see TrainingEncoder::buildInputTensors). 
+		torch::Tensor stateDevice = device.is_cpu() ? state : torch::empty({ 1, LSTM_INPUT_SIZE }, torch::TensorOptions().dtype(torch::kFloat32).device(device));
+		for(uint32_t episode = 0; episode < numOfEpisodes; episode++) {
+			environment->reset(1);
+			float totalReward = 0.0F;
+			uint32_t steps = 0;
+			while(!environment->gameOver() && steps < parameters->maxEpisodeLength) {
+				environment->update();
+				TrainingEncoder::buildInputTensors(environment, 1, inputData, inputTensor, state, stateDevice);
+				std::tuple<torch::Tensor, torch::Tensor> output = policy.forward(stateDevice);
+				environment->onAction(0, TrainingEncoder::decodeAction(0, std::get<0>(output)[0]));
+				totalReward += environment->rewardAgent(0);
+				steps++;
+			}
+			std::cout << "Episode " + std::to_string(episode) + ": reward " + std::to_string(totalReward) + ", steps " + std::to_string(steps) << std::endl;
+		}
+		delete environment;
+		return 0;
+	}
+
+	Environment* enviroment;
+	if(parameters->numOfEnvironments > 1) {
+		// Step multiple independent instances per tick, each played by its own agent. 
+		enviroment = new VectorEnvironment(parameters->numOfEnvironments, parameters->numOfEnvironmentThreads, environmentFactory);
+	} else {
+		enviroment = environmentFactory();
+	}
 
 	// Determine actual num of agents. 
-	NUM_OF_AGENTS = Maths::min(NUM_OF_AGENTS_DESIRED, enviroment->maxNumOfAgents());
+	NUM_OF_AGENTS = Maths::min(Maths::max(NUM_OF_AGENTS_DESIRED, parameters->numOfEnvironments), enviroment->maxNumOfAgents());
 	
 	// Init training controller. 
 	//TrainingController* trainingController = new TrainingControllerContinuous(parameters, enviroment);
@@ -46,7 +105,9 @@ int main(int argc, const char** argv) {
 	bool stop = false;
 	bool actionTaken = false;
 	float action = 0.0F;
-	std::vector<torch::Tensor> output;
+	std::vector<std::vector<torch::Tensor>> outputs = std::vector<std::vector<torch::Tensor>>(NUM_OF_AGENTS);
+	std::vector<AGENT_ID> actingAgentIDs;
+	std::vector<float> actions;
 	bool episodeReachedMaxLength = false;
 	bool environmentCaused = false;
 	std::chrono::high_resolution_clock::time_point lastKeepAliveSent;
@@ -59,10 +120,15 @@ int main(int argc, const char** argv) {
 		enviroment->update();
 
 		// Update agents. 
-		for(uint32_t agentID = 0; agentID < NUM_OF_AGENTS; agentID++) {
-			// Get action to take. 
+		actingAgentIDs.clear();
+		actions.clear();
+		// Get actions to take. The policies of all agents are evaluated at once. 
+		for(std::vector<torch::Tensor>& output : outputs) {
 			output.clear();
-			actionTaken = trainingController->onActionRequired(agentID, output);
+		}
+		trainingController->onActionsRequired(outputs);
+		for(uint32_t agentID = 0; agentID < NUM_OF_AGENTS; agentID++) {
+			actionTaken = !outputs[agentID].empty();
 
 			if(actionTaken) {
 				// Determine whether an action based on the agents output or a random action should be taken. 
@@ -77,24 +143,38 @@ int main(int argc, const char** argv) {
 				}
 				if(!randomAction) {
 					// Decode action based on agent output. 
-					action = TrainingEncoder::decodeAction(agentID, output[0]);
+					action = TrainingEncoder::decodeAction(agentID, outputs[agentID][0]);
 				} else {
 					// Take a random action. 
 					action = epsilonGreedyRandom.nextFloatInRange(0.0F, enviroment->getActionMax());
 				}
 
-				// Execute action. 
-				enviroment->onAction(agentID, action);
+				// Remember action, all actions are executed at once below. 
+				actingAgentIDs.push_back(agentID);
+				actions.push_back(action);
+			}
+		}
+
+		// Execute actions (the environment may step its instances concurrently) and reward agents once all of them stepped. 
+		if(!actingAgentIDs.empty()) {
+			enviroment->onActions(actingAgentIDs, actions);
+			trainingController->onAgentsExecuted(actingAgentIDs);
+		}
 
-				// Reward agent. 
-				trainingController->onAgentExecuted(agentID);
+		// Finish episodes of agents whose environment instance reached game over on its own. 
+		for(uint32_t agentID = 0; agentID < NUM_OF_AGENTS && !stop; agentID++) {
+			if(enviroment->agentGameOver(agentID)) {
+				TrainingLogger::onEpisodeTerminated(trainingController->getTrainedEpisodes(), false, true);
+				stop = trainingController->onAgentEpisodeEnded(agentID);
+				// Update currentEpisodeProgress. 
+				currentEpisodeProgress = static_cast<double>(trainingController->getTrainedEpisodes()) / static_cast<double>(parameters->maxEpisodes);
 			}
 		}
 
 		// Finish tick. 
 		episodeReachedMaxLength = trainingController->onGameTickPassed();
 		environmentCaused = enviroment->gameOver();
-		if(episodeReachedMaxLength || environmentCaused) {
+		if(!stop && (episodeReachedMaxLength || environmentCaused)) {
 			TrainingLogger::onEpisodeTerminated(trainingController->getTrainedEpisodes(), episodeReachedMaxLength, environmentCaused);
 			if(trainingController->onNextScenarioRequired(false)) {
 				stop = true;
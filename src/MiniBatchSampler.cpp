@@ -0,0 +1,37 @@
+#include "MiniBatchSampler.h"
+
+using namespace PLANS;
+
+//############################ MiniBatchSampler ############################
+
+// PUBLIC
+
+MiniBatchSampler::MiniBatchSampler(int64_t numOfSamples, uint32_t numOfMiniBatches, bool shuffle, const torch::Device& device) : numOfSamples(numOfSamples), numOfMiniBatches(0), miniBatchSize(0), shuffle(shuffle), device(device), permutation() {
+	if(numOfSamples > 0 && numOfMiniBatches > 0) {
+		this->numOfMiniBatches = static_cast<uint32_t>(std::min<int64_t>(numOfMiniBatches, numOfSamples));
+		miniBatchSize = numOfSamples / this->numOfMiniBatches;
+	}
+}
+
+void MiniBatchSampler::nextEpoch() {
+	if(shuffle && numOfSamples > 0) {
+		permutation = torch::randperm(numOfSamples, torch::TensorOptions().device(device).dtype(torch::kInt64));
+	}
+}
+
+uint32_t MiniBatchSampler::getNumOfMiniBatches() const {
+	return numOfMiniBatches;
+}
+
+int64_t MiniBatchSampler::getMiniBatchSize() const {
+	return miniBatchSize;
+}
+
+torch::Tensor MiniBatchSampler::gather(const torch::Tensor& source, uint32_t miniBatchIndex) const {
+	int64_t start = miniBatchIndex * miniBatchSize;
+	if(!shuffle) {
+		// Contiguous samples, no copy required. 
+		return source.slice(0, start, start + miniBatchSize);
+	}
+	return source.index_select(0, permutation.slice(0, start, start + miniBatchSize));
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "TrainingConsts.h"
+
+namespace PLANS {
+
+	//############################ MiniBatchSampler ############################
+
+	/*
+	*	Splits the samples of an optimization step into mini batches, once per epoch. 
+	*		- If shuffling is enabled, every epoch draws a new random permutation of the samples and mini batches are gathered with a single "index_select" per tensor. 
+	*		- Otherwise the mini batches are contiguous and returned as views. 
+	*		- All mini batches have the same size, remaining samples are left out (different ones each epoch if shuffled). 
+	*/
+	class MiniBatchSampler {
+		public:
+			// "numOfMiniBatches" is capped at "numOfSamples". The permutations are created on the given device. 
+			MiniBatchSampler(int64_t numOfSamples, uint32_t numOfMiniBatches, bool shuffle, const torch::Device& device);
+
+			// Starts a new epoch. 
+			void nextEpoch();
+
+			uint32_t getNumOfMiniBatches() const;
+			int64_t getMiniBatchSize() const;
+			// Returns the rows of "source" (first dimension = samples) belonging to the given mini batch of the current epoch. 
+			torch::Tensor gather(const torch::Tensor& source, uint32_t miniBatchIndex) const;
+		protected:
+		private:
+			int64_t numOfSamples;
+			uint32_t numOfMiniBatches;
+			int64_t miniBatchSize;
+			bool shuffle;
+			torch::Device device;
+			torch::Tensor permutation;	// Sample indices of the current epoch (only if shuffled). 
+	};
+
+}
@@ -199,7 +199,8 @@ std::tuple<torch::Tensor, torch::Tensor> ActorCriticOpenAIFiveImpl::forward(cons
         hidden = hx_options;
     } else {
         // Detach to avoid an update of the hidden states (source: https://stackoverflow.com/questions/75842061/i-dont-think-there-is-an-inplace-operation-but-an-inplace-operation-error-occu). 
-        hidden = std::make_tuple(std::get<0>(hx_options).detach(), std::get<1>(hx_options).detach());
+        // Cloned, as hidden states of a rollout forward pass are inference tensors (see TrainingController::runPolicies), which can't be saved for backward. 
+        hidden = std::make_tuple(std::get<0>(hx_options).detach().clone(), std::get<1>(hx_options).detach().clone());
         std::get<0>(hx_options).set_requires_grad(false);
         std::get<1>(hx_options).set_requires_grad(false);
     }
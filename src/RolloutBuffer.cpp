@@ -0,0 +1,75 @@
+#include "RolloutBuffer.h"
+
+#include <cstring>
+
+using namespace PLANS;
+
+//############################ RolloutBuffer ############################
+
+// PUBLIC
+
+RolloutBuffer::RolloutBuffer(uint32_t initialCapacity) : rewards(), totalReward(0.0), rewardsCount(0), capacity(0), numOfSteps(0), states(), actions(), logProbs(), values() {
+	allocate(initialCapacity > 0 ? initialCapacity : 1);
+}
+
+void RolloutBuffer::addStep(const float* state, float action, const float* logProb, float value) {
+	if(numOfSteps == capacity) {
+		allocate(capacity * 2);
+	}
+	std::memcpy(states.data_ptr<float>() + static_cast<size_t>(numOfSteps) * LSTM_INPUT_SIZE, state, LSTM_INPUT_SIZE * sizeof(float));
+	actions.data_ptr<float>()[numOfSteps] = action;
+	std::memcpy(logProbs.data_ptr<float>() + static_cast<size_t>(numOfSteps) * LSTM_OUTPUT_SIZE, logProb, LSTM_OUTPUT_SIZE * sizeof(float));
+	values.data_ptr<float>()[numOfSteps] = value;
+	numOfSteps++;
+}
+
+void RolloutBuffer::clear() {
+	numOfSteps = 0;
+	rewards.clear();
+	totalReward = 0.0;
+	rewardsCount = 0;
+}
+
+uint32_t RolloutBuffer::getNumOfSteps() const {
+	return numOfSteps;
+}
+
+torch::Tensor RolloutBuffer::getStates() const {
+	return states.slice(0, 0, numOfSteps);
+}
+
+torch::Tensor RolloutBuffer::getActions() const {
+	return actions.slice(0, 0, numOfSteps);
+}
+
+torch::Tensor RolloutBuffer::getLogProbs() const {
+	return logProbs.slice(0, 0, numOfSteps);
+}
+
+torch::Tensor RolloutBuffer::getValues() const {
+	return values.slice(0, 0, numOfSteps);
+}
+
+// PRIVATE
+
+void RolloutBuffer::allocate(uint32_t newCapacity) {
+	torch::TensorOptions options = torch::TensorOptions().device(torch::kCPU).dtype(torch::kFloat32).requires_grad(false);
+	torch::Tensor newStates = torch::empty({ newCapacity, LSTM_INPUT_SIZE }, options);
+	torch::Tensor newActions = torch::empty({ newCapacity }, options);
+	torch::Tensor newLogProbs = torch::empty({ newCapacity, LSTM_OUTPUT_SIZE }, options);
+	torch::Tensor newValues = torch::empty({ newCapacity }, options);
+	// Keep existing steps. 
+	if(numOfSteps > 0) {
+		newStates.slice(0, 0, numOfSteps).copy_(getStates());
+		newActions.slice(0, 0, numOfSteps).copy_(getActions());
+		newLogProbs.slice(0, 0, numOfSteps).copy_(getLogProbs());
+		newValues.slice(0, 0, numOfSteps).copy_(getValues());
+	}
+	states = newStates;
+	actions = newActions;
+	logProbs = newLogProbs;
+	values = newValues;
+	capacity = newCapacity;
+	// Rewards are added once per step as well. 
+	rewards.reserve(newCapacity);
+}
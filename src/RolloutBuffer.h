@@ -0,0 +1,45 @@
+#pragma once
+
+#include "TrainingConsts.h"
+
+namespace PLANS {
+
+	//############################ RolloutBuffer ############################
+
+	/*
+	*	Experience collected by an agent between two optimization steps. 
+	*		- Steps are written in place into preallocated CPU tensors, one row per step. 
+	*		- If the capacity is exceeded, the storage is doubled. "clear" keeps the storage, so after the first rollouts no allocations happen anymore. 
+	*		- The getters return zero-copy views on the first "getNumOfSteps()" rows. 
+	*/
+	class RolloutBuffer {
+		public:
+			std::vector<double> rewards;
+			double totalReward;
+			uint32_t rewardsCount;
+
+			explicit RolloutBuffer(uint32_t initialCapacity);
+
+			// Appends a step. "state" points to LSTM_INPUT_SIZE values, "logProb" to LSTM_OUTPUT_SIZE values. 
+			void addStep(const float* state, float action, const float* logProb, float value);
+			// Removes all steps and rewards. 
+			void clear();
+
+			uint32_t getNumOfSteps() const;
+			torch::Tensor getStates() const;		// Size: { numOfSteps, LSTM_INPUT_SIZE }. 
+			torch::Tensor getActions() const;		// Size: { numOfSteps }. 
+			torch::Tensor getLogProbs() const;		// Size: { numOfSteps, LSTM_OUTPUT_SIZE }. 
+			torch::Tensor getValues() const;		// Size: { numOfSteps }. 
+		protected:
+		private:
+			uint32_t capacity;
+			uint32_t numOfSteps;
+			torch::Tensor states;
+			torch::Tensor actions;
+			torch::Tensor logProbs;
+			torch::Tensor values;
+
+			void allocate(uint32_t newCapacity);
+	};
+
+}
@@ -0,0 +1,57 @@
+#include "StateArena.h"
+
+#include "TrainingEncoder.h"
+
+using namespace PLANS;
+
+//############################ StateArena ############################
+
+// PUBLIC
+
+StateArena::StateArena(uint32_t numOfAgents) : numOfAgents(numOfAgents), nextSlot(0), states(), statesDevice(), slotStates(), slotStatesDevice(), stateDatas(), inputData(), inputTensor() {
+	torch::TensorOptions options = TrainingController::getInstance()->getTensorOptionsCPU();
+	inputData = std::vector<float>(static_cast<size_t>(numOfAgents) * LSTM_INPUT_SIZE);
+	inputTensor = torch::from_blob(inputData.data(), { numOfAgents, LSTM_INPUT_SIZE }, options);
+#ifdef USE_CUDA
+	// Pinned, so the rows can be copied to the GPU asynchronously. 
+	states = torch::empty({ static_cast<int64_t>(STATE_ARENA_SLOTS), numOfAgents, LSTM_INPUT_SIZE }, options.pinned_memory(true));
+	statesDevice = torch::empty({ static_cast<int64_t>(STATE_ARENA_SLOTS), numOfAgents, LSTM_INPUT_SIZE }, TrainingController::getInstance()->getTensorOptions());
+#else
+	states = torch::empty({ static_cast<int64_t>(STATE_ARENA_SLOTS), numOfAgents, LSTM_INPUT_SIZE }, options);
+	statesDevice = states;
+#endif
+	slotStates.reserve(STATE_ARENA_SLOTS);
+	slotStatesDevice.reserve(STATE_ARENA_SLOTS);
+	stateDatas.reserve(static_cast<size_t>(STATE_ARENA_SLOTS) * numOfAgents);
+	for(uint32_t s = 0; s < STATE_ARENA_SLOTS; s++) {
+		slotStates.push_back(states[s]);
+		slotStatesDevice.push_back(statesDevice[s]);
+		for(uint32_t i = 0; i < numOfAgents; i++) {
+			StateData* stateData = new StateData(0);
+			stateData->inputTensor = slotStates[s].slice(0, i, i + 1);
+			stateData->inputTensorDevice = slotStatesDevice[s].slice(0, i, i + 1);
+			stateDatas.push_back(stateData);
+		}
+	}
+}
+
+StateArena::~StateArena() {
+	for(StateData* stateData : stateDatas) {
+		delete stateData;
+	}
+}
+
+StateData* const* StateArena::buildStep(Environment* environment, uint32_t stepIndex) {
+	uint32_t slot = nextSlot;
+	nextSlot = (nextSlot + 1) % STATE_ARENA_SLOTS;
+	TrainingEncoder::buildInputTensors(environment, numOfAgents, inputData, inputTensor, slotStates[slot], slotStatesDevice[slot]);
+	StateData* const* slotStateDatas = &stateDatas[static_cast<size_t>(slot) * numOfAgents];
+	for(uint32_t i = 0; i < numOfAgents; i++) {
+		slotStateDatas[i]->stepIndex = stepIndex;
+	}
+	return slotStateDatas;
+}
+
+void StateArena::reset() {
+	nextSlot = 0;
+}
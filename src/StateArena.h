@@ -0,0 +1,42 @@
+#pragma once
+
+#include "trainingController/TrainingController.h"
+
+namespace PLANS {
+
+	class Environment;
+
+	constexpr uint32_t STATE_ARENA_SLOTS = 2;
+
+	//############################ StateArena ############################
+
+	/*
+	*	Storage of the state datas of all agents for the latest steps. 
+	*		- The observations of a step are encoded directly into preallocated rows (pinned, if CUDA is used), which are copied into preallocated device rows asynchronously. 
+	*		- The rollouts copy the states of a step when acting on it (see RolloutBuffer), so only the current step is kept. The rows form a ring of STATE_ARENA_SLOTS steps, which is allocated once. 
+	*		- The ring has two slots, so the rows of a step aren't overwritten by the next step while their copy to the device may be pending. 
+	*		- A state data stays valid until STATE_ARENA_SLOTS further steps have been built. 
+	*/
+	class StateArena {
+		public:
+			explicit StateArena(uint32_t numOfAgents);
+			~StateArena();
+
+			// Encodes the observations of all agents for the given step (see TrainingEncoder::buildInputTensors). Returns the state data of every agent. 
+			StateData* const* buildStep(Environment* environment, uint32_t stepIndex);
+			// Starts again at the first slot. 
+			void reset();
+		protected:
+		private:
+			uint32_t numOfAgents;
+			uint32_t nextSlot;
+			torch::Tensor states;						// Size: { STATE_ARENA_SLOTS, numOfAgents, LSTM_INPUT_SIZE }, CPU. 
+			torch::Tensor statesDevice;					// Like "states", on the actual device. Equals "states", if the device is the CPU. 
+			std::vector<torch::Tensor> slotStates;		// Views on the rows of a slot, to not create them every step. 
+			std::vector<torch::Tensor> slotStatesDevice;
+			std::vector<StateData*> stateDatas;			// Index: slot * numOfAgents + agentID. 
+			std::vector<float> inputData;	// Observations of the current step, before encoding. 
+			torch::Tensor inputTensor;		// View on "inputData". 
+	};
+
+}
@@ -30,7 +30,7 @@ namespace PLANS {
 	using AGENT_ID = uint32_t;
 
 	static const std::string LOGS_DIRECTORY_PATH = "./logs/";
-	static const std::string CHECKPOINT_FILE_EXTENSION = ".checkpoint";
+	static const std::string SCRIPTED_POLICY_FILE_EXTENSION = ".pt";
 
 	constexpr uint32_t NUM_OF_AGENTS_DESIRED = 1;	// Not the actual amount, see NUM_OF_AGENTS. 
 
@@ -48,7 +48,7 @@ namespace PLANS {
 
 	static const std::chrono::system_clock::time_point TRAINING_START = std::chrono::system_clock::now();
 	static int TRAINING_STEPS = 0;
-	static uint32_t NUM_OF_AGENTS = NUM_OF_AGENTS_DESIRED;	// Actual amount, depends on the maximum amount supported by the environment. 
+	inline uint32_t NUM_OF_AGENTS = NUM_OF_AGENTS_DESIRED;	// Actual amount, depends on the maximum amount supported by the environment. Inline, so all translation units share the value set in Main.cpp. 
 
 	static std::string VM_ADDRESS = "217.160.210.2";
 	static uint16_t VM_PORT = 25565;
@@ -4,58 +4,29 @@
 
 using namespace PLANS;
 
-StateData* TrainingEncoder::buildInputTensor(AGENT_ID agentID, Environment* environment) {
-    // Put all data into a vector. Put this into a tensor with the dimensions { TrainingController::getInstance()->LSTM_SEQUENCE_LENGTH, TrainingController::getInstance()->LSTM_BATCH_SIZE, TrainingController::getInstance()->LSTM_INPUT_SIZE } ("inputTensor"). 
-    // The final tensor is located on the correct device (CPU / CUDA). 
-    // The final tensor is packed into a "StateData" object, along with the IDs of the encoded spaceships. 
+void TrainingEncoder::buildInputTensors(Environment* environment, uint32_t numOfAgents, std::vector<float>& data, const torch::Tensor& dataTensor, torch::Tensor& states, torch::Tensor& statesDevice) {
+    // Put the data of all agents into "data" (one row per agent), which is viewed by "dataTensor". 
+    // The softmax of every row is written into "states" directly, which is copied to the correct device (CPU / CUDA) at once. 
 
-    // Prepare state data. 
-    StateData* stateData = new StateData(TrainingController::getInstance()->getStepsInThisEpisode());
-
-    // Prepare data vector. 
-    std::vector<float> data = std::vector<float>(LSTM_INPUT_SIZE);
-
-    environment->getInputData(agentID, data);
+    environment->getInputDataBatch(numOfAgents, data);
 
 #ifdef _DEBUG
     // Check if any value is NaN. 
-    for(uint32_t i = 0; i < LSTM_INPUT_SIZE; i++) {
+    for(uint32_t i = 0; i < numOfAgents * LSTM_INPUT_SIZE; i++) {
         if(std::isnan(data[i])) {
-            TrainingController::getInstance()->consoleOut("TrainingEncoder::buildInputTensor: Value at index " + std::to_string(i) + " is NaN.");
+            TrainingController::getInstance()->consoleOut("TrainingEncoder::buildInputTensors: Value at index " + std::to_string(i) + " is NaN.");
             abort();
         }
     }
 #endif
 
-    torch::Tensor dataTensor = torch::from_blob(data.data(), LSTM_INPUT_SIZE, TrainingController::getInstance()->getTensorOptionsCPU());
-    //dataTensor.size(0);
-
-    //double d_0 = dataTensor[LSTM_INPUT_SIZE - 1].item().toDouble();
-
-    // Softmax input data. 
-    dataTensor = dataTensor.softmax(0);
-
-    //double d_1 = dataTensor[LSTM_INPUT_SIZE - 1].item().toDouble();
-
-    //// Build tensor. 
-    //stateData->inputTensor = torch::empty({ TrainingController::getInstance()->LSTM_SEQUENCE_LENGTH, TrainingController::getInstance()->LSTM_INPUT_SIZE }, TrainingController::getInstance()->getTensorOptionsCPU());
-    //for(int64_t i = 0; i < TrainingController::getInstance()->LSTM_SEQUENCE_LENGTH; i++) {
-    //    //torch::Tensor tensorC = torch::from_blob(data.data(), TrainingController::getInstance()->LSTM_INPUT_SIZE, TrainingController::getInstance()->getTensorOptionsCPU());
-    //    //batchTensor.index_put_({ k }, dataTensor);
-    //    stateData->inputTensor[i] = dataTensor;
-    //}
-    stateData->inputTensor = torch::empty({ 1, LSTM_INPUT_SIZE }, TrainingController::getInstance()->getTensorOptionsCPU());
-    stateData->inputTensor[0] = dataTensor;
-    //std::cout << inputTensor << std::endl;
+    // Softmax input data of each agent. 
+    torch::softmax_out(states, dataTensor, 1);
 
 #ifdef USE_CUDA
-    // Copy tensor to GPU. 
-    stateData->inputTensorDevice = stateData->inputTensor.to(torch::kCUDA);
-#else
-    stateData->inputTensorDevice = stateData->inputTensor.to(torch::kCPU);
+    // Copy tensor to GPU. "states" is pinned, so the copy doesn't block. 
+    statesDevice.copy_(states, true);
 #endif
-    
-    return stateData;
 }
 
 float TrainingEncoder::decodeAction(AGENT_ID agentID, const torch::Tensor& actorOutput) {
@@ -65,7 +36,8 @@ float TrainingEncoder::decodeAction(AGENT_ID agentID, const torch::Tensor& actor
         abort();
     }
 
-    float output = actorOutput[0].item<float>();
+    // The outputs are on the CPU already (see TrainingController::runPolicies), so the value is read directly instead of dispatching "item". 
+    float output = actorOutput.is_cpu() ? actorOutput.data_ptr<float>()[0] : actorOutput[0].item<float>();
     //std::cout << std::to_string(TrainingController::getInstance()->getStepsInThisEpisode()) + ": " + std::to_string(output) << std::endl;
 
     //for(int64_t i = 0; i < TrainingController::getInstance()->LSTM_OUTPUT_SIZE; i++) {
@@ -8,7 +8,9 @@ namespace PLANS {
 
 	class TrainingEncoder {
 		public:
-			static StateData* buildInputTensor(AGENT_ID agentID, Environment* environment);
+			// Encodes one observation batch of the first "numOfAgents" agents into "states" and "statesDevice" (both of size { numOfAgents, LSTM_INPUT_SIZE }). 
+			// "data" and "dataTensor" are the scratch buffer for the observations and a view on it. Nothing is allocated (see StateArena). 
+			static void buildInputTensors(Environment* environment, uint32_t numOfAgents, std::vector<float>& data, const torch::Tensor& dataTensor, torch::Tensor& states, torch::Tensor& statesDevice);
 
 			static float decodeAction(AGENT_ID agentID, const torch::Tensor& actorOutput);
 		protected:
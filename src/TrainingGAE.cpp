@@ -0,0 +1,43 @@
+#include "TrainingGAE.h"
+
+#include <vector>
+
+using namespace PLANS;
+
+void TrainingGAE::computeReturns(const float* rewards, const float* values, uint32_t numOfSteps, uint32_t numOfEnvironments, double gamma, double lambda, float* returns, float* advantages) {
+	if(numOfSteps == 0 || numOfEnvironments == 0) {
+		return;
+	}
+	// Same precision as the tensor arithmetic (float32). 
+	const float gammaF = static_cast<float>(gamma);
+	const float gammaLambda = static_cast<float>(gamma * lambda);
+	const size_t stride = numOfEnvironments;
+
+	// Running GAE of every environment. 
+	std::vector<float> gae = std::vector<float>(numOfEnvironments, 0.0F);
+	float* gaeData = gae.data();
+
+	// Reverse scan. 
+	for(size_t i = numOfSteps - 1; i > 0; i--) {
+		const float* stepRewards = rewards + i * stride;
+		const float* stepValues = values + i * stride;
+		const float* previousValues = stepValues - stride;
+		float* stepReturns = returns + i * stride;
+		for(size_t e = 0; e < stride; e++) {
+			float delta = stepRewards[e] + gammaF * previousValues[e] - stepValues[e];	// See [SchulmanEtAl, 2017]_PPO, Equation (12)
+			gaeData[e] = delta + gammaLambda * gaeData[e];
+			stepReturns[e] = gaeData[e] + stepValues[e];
+		}
+	}
+	// The first step is not reached by the scan. 
+	for(size_t e = 0; e < stride; e++) {
+		returns[e] = 0.0F;
+	}
+
+	if(advantages != nullptr) {
+		const size_t count = static_cast<size_t>(numOfSteps) * stride;
+		for(size_t i = 0; i < count; i++) {
+			advantages[i] = returns[i] - values[i];
+		}
+	}
+}
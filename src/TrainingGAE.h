@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace PLANS {
+
+	class TrainingGAE {
+		public:
+			// Computes the returns (generalized advantage estimation, see [SchulmanEtAl, 2017]_PPO, Equation (11) and (12)) of "numOfEnvironments" rollouts with "numOfSteps" steps each. 
+			// All arrays are time-major: The value of environment "e" at step "i" is at index "i * numOfEnvironments + e". The inner loop runs over the environments, so it can be vectorized. 
+			// Matches the results of the original tensor based loop: The TD error of step "i" uses the value of step "i - 1" and the return of step 0 is 0. 
+			// "advantages" (returns minus values) is optional. 
+			static void computeReturns(const float* rewards, const float* values, uint32_t numOfSteps, uint32_t numOfEnvironments, double gamma, double lambda, float* returns, float* advantages = nullptr);
+		protected:
+		private:
+	};
+
+}
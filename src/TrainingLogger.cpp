@@ -117,12 +117,31 @@ void TrainingLogger::onTrainingStarted(const TrainingParameters* trainingParamet
 	appendLineToFile(">maxEpisodeLength	:	" + std::to_string(trainingParameters->maxEpisodeLength));
 	appendLineToFile(">episodesPerCheckpoint	:	" + std::to_string(trainingParameters->episodesPerCheckpoint));
 	appendLineToFile(">maxEpisodes	:	" + std::to_string(trainingParameters->maxEpisodes));
+	appendLineToFile(">maxPendingCheckpoints	:	" + std::to_string(trainingParameters->maxPendingCheckpoints));
+	appendLineToFile(">checkpointCompressionLevel	:	" + std::to_string(trainingParameters->checkpointCompressionLevel));
+	appendLineToFile(">checkpointCompressionThreads	:	" + std::to_string(trainingParameters->checkpointCompressionThreads));
+	appendLineToFile(">checkpointStreaming	:	" + std::string(trainingParameters->checkpointStreaming ? "true" : "false"));
+	appendLineToFile(">checkpointMapped	:	" + std::string(trainingParameters->checkpointMapped ? "true" : "false"));
+	appendLineToFile(">checkpointDeltaInterval	:	" + std::to_string(trainingParameters->checkpointDeltaInterval));
+	appendLineToFile(">checkpointKeepLast	:	" + std::to_string(trainingParameters->checkpointKeepLast));
+	appendLineToFile(">checkpointKeepEvery	:	" + std::to_string(trainingParameters->checkpointKeepEvery));
+	appendLineToFile(">exportScriptedPolicy	:	" + std::string(trainingParameters->exportScriptedPolicy ? "true" : "false"));
+	appendLineToFile(">numOfEnvironments	:	" + std::to_string(trainingParameters->numOfEnvironments));
+	appendLineToFile(">numOfEnvironmentThreads	:	" + std::to_string(trainingParameters->numOfEnvironmentThreads));
+	appendLineToFile(">frameSkip	:	" + std::to_string(trainingParameters->frameSkip));
+	appendLineToFile(">frameMaxPool	:	" + std::string(trainingParameters->frameMaxPool ? "true" : "false"));
+	appendLineToFile(">frameStack	:	" + std::to_string(trainingParameters->frameStack));
+	appendLineToFile(">startStatePoolSize	:	" + std::to_string(trainingParameters->startStatePoolSize));
+	appendLineToFile(">maxStartNoOps	:	" + std::to_string(trainingParameters->maxStartNoOps));
+	appendLineToFile(">fastInference	:	" + std::string(trainingParameters->fastInference ? "true" : "false"));
+	appendLineToFile(">asyncLearner	:	" + std::string(trainingParameters->asyncLearner ? "true" : "false"));
 	appendLineToFile(">continueLogFile	:	" + std::string(trainingParameters->continueLogFile ? "true" : "false"));
 	appendLineToFile(">ppo_gamma	:	" + std::to_string(trainingParameters->ppo_gamma));
 	appendLineToFile(">ppo_lambda	:	" + std::to_string(trainingParameters->ppo_lambda));
 	appendLineToFile(">ppo_beta	:	" + std::to_string(trainingParameters->ppo_beta));
 	appendLineToFile(">ppo_epochs	:	" + std::to_string(trainingParameters->ppo_epochs));
-	appendLineToFile(">ppo_miniBatchSize	:	" + std::to_string(trainingParameters->ppo_miniBatchSize));
+	appendLineToFile(">ppo_miniBatches	:	" + std::to_string(trainingParameters->ppo_miniBatches));
+	appendLineToFile(">ppo_shuffleSamples	:	" + std::string(trainingParameters->ppo_shuffleSamples ? "true" : "false"));
 	appendLineToFile(">epsilonGreedyEnabled	:	" + std::string(trainingParameters->epsilonGreedyEnabled ? "true" : "false"));
 	appendLineToFile(">epsilonGreedyStart	:	" + std::to_string(trainingParameters->epsilonGreedyStart));
 	appendLineToFile(">epsilonGreedyEnd	:	" + std::to_string(trainingParameters->epsilonGreedyEnd));
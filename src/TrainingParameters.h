@@ -13,16 +13,35 @@ namespace PLANS {
 		std::string modelNameSave;
 		double learningRate;
 		uint32_t policyStepLength;		// How often the agents take action. 
-		uint32_t trainingStepLength;	// After how many agent actions the optimizer is executed. 
+		uint32_t trainingStepLength;	// After how many agent actions (TrainingControllerContinuous) or agent episodes (TrainingControllerEpisodic) the optimizer is executed. 
 		uint32_t maxEpisodeLength;		// Maximum lock steps until episode is terminated. 
-		uint32_t episodesPerCheckpoint;	// After how many episodes a checkpoint is being created. -1 for no checkpoints (not recommended). 
-		uint32_t maxEpisodes;			// After how many episodes the training should be terminated. 0 for infinite. 
+		uint32_t episodesPerCheckpoint;	// After how many episodes a checkpoint is being created. -1 for no checkpoints (not recommended). Every agent episode counts (see numOfEnvironments). 
+		uint32_t maxEpisodes;			// After how many episodes the training should be terminated. 0 for infinite. Every agent episode counts (see numOfEnvironments). 
+		uint32_t maxPendingCheckpoints;	// How many checkpoints may be written in the background at once. Creating a checkpoint blocks the training while this limit is reached. 
+		uint32_t checkpointCompressionLevel;	// 0 stores checkpoints uncompressed (fastest), 1 (fast) to 9 (small) deflates them. 
+		uint32_t checkpointCompressionThreads;	// How many threads compress and decompress the blocks of a checkpoint. 0 for one thread per hardware thread. 
+		bool checkpointStreaming;		// Whether checkpoints are serialized directly into a gzip compressed file (single threaded, low memory) instead of being block compressed in memory. 
+		bool checkpointMapped;			// Whether checkpoints are written uncompressed with aligned tensors, so they are memory mapped when loaded (see MappedCheckpoint). Takes precedence over checkpointStreaming. 
+		uint32_t checkpointDeltaInterval;	// Every how many checkpoints a full one is written, the ones in between only store the difference to it (see DeltaCheckpoint). 0 to disable. 
+		uint32_t checkpointKeepLast;	// How many of the latest checkpoints are kept, older ones are deleted (see CheckpointIndex). 0 keeps all checkpoints. 
+		uint32_t checkpointKeepEvery;	// Checkpoints of episodes which are a multiple of this are kept in addition to the latest ones. 0 to disable. 
+		bool exportScriptedPolicy;		// Whether every checkpoint is also exported as frozen TorchScript module, which is evaluated via "--evaluate" (see ScriptedPolicy). 
+		uint32_t numOfEnvironments;		// How many independent environment instances are stepped per tick (see VectorEnvironment). Each instance is played by its own agent, all agents share one policy. 
+		uint32_t numOfEnvironmentThreads;	// How many threads step the environment instances concurrently. 0 for one thread per hardware thread. 
+		uint32_t frameSkip;				// How often an action is repeated, so the agents decide only every "frameSkip" frames (see FrameSkipEnvironment). 1 to decide every frame. 
+		bool frameMaxPool;				// Whether the observation is the maximum of the last two frames of a repeated action. Only used, if frameSkip is greater than 1. 
+		uint32_t frameStack;			// How many of the last observations form the input. The observation size of the environment times this has to equal LSTM_INPUT_SIZE (see FrameSkipEnvironment). 
+		uint32_t startStatePoolSize;	// How many start states each environment instance clones, so resets restore one of them instead of replaying the startup frames (see EnvironmentBreakout). 0 to reset the game. 
+		uint32_t maxStartNoOps;			// Maximum number of random no-op frames before a start state is cloned. 
+		bool fastInference;				// Whether the actors evaluate the model via FastActorCritic instead of the torch module. Only used, if the model runs on the CPU. 
+		bool asyncLearner;				// Whether the agents are optimized on a separate learner thread while the next rollouts are collected (double buffered). The actors use the new weights once an optimization finished. 
 		bool continueLogFile;			// Wether a log file with matching name should be continued or a new log file should be created. 
 		double ppo_gamma;
 		double ppo_lambda;
 		double ppo_beta;
 		uint32_t ppo_epochs;
-		uint32_t ppo_miniBatchSize;		// Calculated automatically (trainingStepLength / ppo_epochs). 
+		uint32_t ppo_miniBatches;		// Into how many mini batches the samples are split per ppo_epoch. The mini batch size results from the number of samples of each optimization. 
+		bool ppo_shuffleSamples;		// Whether the samples are shuffled every ppo_epoch (recommended) or used in their original order. 
 		bool epsilonGreedyEnabled;
 		double epsilonGreedyStart;
 		double epsilonGreedyEnd;
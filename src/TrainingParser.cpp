@@ -16,6 +16,7 @@ const uint32_t TrainingParser::STD_POLICY_STEP_LENGTH = 5;
 const uint32_t TrainingParser::STD_TRAINING_STEP_LENGTH = 120;
 const uint32_t TrainingParser::STD_MAX_EPISODE_LENGTH = 30000;
 const uint32_t TrainingParser::STD_PPO_EPOCHS = 4;	// Never 0. 
+const uint32_t TrainingParser::STD_PPO_MINI_BATCHES = 4;	// Never 0. 
 
 void TrainingParser::parseConfigFile(const std::string& configFileName, TrainingParameters* parameters) {
 	// Read file. 
@@ -69,6 +70,96 @@ void TrainingParser::parseConfigFile(const std::string& configFileName, Training
 	} else {
 		parameters->maxEpisodes = 0;	// Infinite. 
 	}
+	if(params.contains("maxPendingCheckpoints")) {
+		parameters->maxPendingCheckpoints = Maths::max<uint32_t>(params["maxPendingCheckpoints"], 1);
+	} else {
+		parameters->maxPendingCheckpoints = 2;
+	}
+	if(params.contains("checkpointCompressionLevel")) {
+		parameters->checkpointCompressionLevel = Maths::min<uint32_t>(params["checkpointCompressionLevel"], 9);
+	} else {
+		parameters->checkpointCompressionLevel = 1;
+	}
+	if(params.contains("checkpointCompressionThreads")) {
+		parameters->checkpointCompressionThreads = params["checkpointCompressionThreads"];
+	} else {
+		parameters->checkpointCompressionThreads = 0;	// One per hardware thread. 
+	}
+	if(params.contains("checkpointStreaming")) {
+		parameters->checkpointStreaming = params["checkpointStreaming"];
+	} else {
+		parameters->checkpointStreaming = false;
+	}
+	if(params.contains("checkpointMapped")) {
+		parameters->checkpointMapped = params["checkpointMapped"];
+	} else {
+		parameters->checkpointMapped = false;
+	}
+	if(params.contains("checkpointDeltaInterval")) {
+		parameters->checkpointDeltaInterval = params["checkpointDeltaInterval"];
+	} else {
+		parameters->checkpointDeltaInterval = 0;	// Disabled. 
+	}
+	if(params.contains("checkpointKeepLast")) {
+		parameters->checkpointKeepLast = params["checkpointKeepLast"];
+	} else {
+		parameters->checkpointKeepLast = 0;	// Keep all. 
+	}
+	if(params.contains("checkpointKeepEvery")) {
+		parameters->checkpointKeepEvery = params["checkpointKeepEvery"];
+	} else {
+		parameters->checkpointKeepEvery = 0;
+	}
+	if(params.contains("exportScriptedPolicy")) {
+		parameters->exportScriptedPolicy = params["exportScriptedPolicy"];
+	} else {
+		parameters->exportScriptedPolicy = false;
+	}
+	if(params.contains("numOfEnvironments")) {
+		parameters->numOfEnvironments = Maths::max<uint32_t>(params["numOfEnvironments"], 1);
+	} else {
+		parameters->numOfEnvironments = 1;
+	}
+	if(params.contains("numOfEnvironmentThreads")) {
+		parameters->numOfEnvironmentThreads = params["numOfEnvironmentThreads"];
+	} else {
+		parameters->numOfEnvironmentThreads = 0;	// One per hardware thread. 
+	}
+	if(params.contains("frameSkip")) {
+		parameters->frameSkip = Maths::max<uint32_t>(params["frameSkip"], 1);
+	} else {
+		parameters->frameSkip = 1;
+	}
+	if(params.contains("frameMaxPool")) {
+		parameters->frameMaxPool = params["frameMaxPool"];
+	} else {
+		parameters->frameMaxPool = true;
+	}
+	if(params.contains("frameStack")) {
+		parameters->frameStack = Maths::max<uint32_t>(params["frameStack"], 1);	// Validated against the environment by FrameSkipEnvironment. 
+	} else {
+		parameters->frameStack = 1;
+	}
+	if(params.contains("startStatePoolSize")) {
+		parameters->startStatePoolSize = params["startStatePoolSize"];
+	} else {
+		parameters->startStatePoolSize = 0;
+	}
+	if(params.contains("maxStartNoOps")) {
+		parameters->maxStartNoOps = params["maxStartNoOps"];
+	} else {
+		parameters->maxStartNoOps = 30;
+	}
+	if(params.contains("fastInference")) {
+		parameters->fastInference = params["fastInference"];
+	} else {
+		parameters->fastInference = true;
+	}
+	if(params.contains("asyncLearner")) {
+		parameters->asyncLearner = params["asyncLearner"];
+	} else {
+		parameters->asyncLearner = false;
+	}
 	if(params.contains("continueLogFile")) {
 		parameters->continueLogFile = params["continueLogFile"];
 	} else {
@@ -94,14 +185,20 @@ void TrainingParser::parseConfigFile(const std::string& configFileName, Training
 		if(parameters->ppo_epochs == 0) {
 			std::cerr << ("TrainingParser::parseConfigFile: ppo_epochs is 0. It must have a greater value.") << std::endl;
 			abort();
-		} else if(parameters->trainingStepLength % parameters->ppo_epochs != 0) {
-			std::cerr << ("TrainingParser::parseConfigFile: trainingStepLength (" + std::to_string(parameters->trainingStepLength) + ") is not a multiples of ppo_epochs (" + std::to_string(parameters->ppo_epochs) + ").") << std::endl;
-			abort();
 		}
 	} else {
 		parameters->ppo_epochs = STD_PPO_EPOCHS;
 	}
-	parameters->ppo_miniBatchSize = parameters->trainingStepLength / parameters->ppo_epochs;
+	if(params.contains("ppo_miniBatches")) {
+		parameters->ppo_miniBatches = Maths::max<uint32_t>(params["ppo_miniBatches"], 1);
+	} else {
+		parameters->ppo_miniBatches = STD_PPO_MINI_BATCHES;
+	}
+	if(params.contains("ppo_shuffleSamples")) {
+		parameters->ppo_shuffleSamples = params["ppo_shuffleSamples"];
+	} else {
+		parameters->ppo_shuffleSamples = true;
+	}
 	if(params.contains("epsilonGreedyEnabled")) {
 		parameters->epsilonGreedyEnabled = params["epsilonGreedyEnabled"];
 	}
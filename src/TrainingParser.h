@@ -17,6 +17,7 @@ namespace PLANS {
 			static const uint32_t STD_TRAINING_STEP_LENGTH;	// How many actions the agents have to take until the optimizer is executed. 
 			static const uint32_t STD_MAX_EPISODE_LENGTH;	// Maximum lock steps until episode is terminated. 
 			static const uint32_t STD_PPO_EPOCHS;			// How often the model is being optimized (via PPO optimization) per PPO call. 
+			static const uint32_t STD_PPO_MINI_BATCHES;		// Into how many mini batches the samples are split per epoch. 
 
 			static void parseConfigFile(const std::string& configFileName, TrainingParameters* parameters);
 	};
@@ -0,0 +1,95 @@
+#include "VectorEnvironment.h"
+
+#include "util/Maths.h"
+
+using namespace PLANS;
+
+//############################ VectorEnvironment ############################
+
+VectorEnvironment::VectorEnvironment(uint32_t numOfEnvironments, uint32_t numOfThreads, const EnvironmentFactory& environmentFactory) : Environment(), environments(), inputDatas(numOfEnvironments, std::vector<float>(LSTM_INPUT_SIZE)), workerPool(nullptr) {
+	environments.reserve(numOfEnvironments);
+	for(uint32_t i = 0; i < numOfEnvironments; i++) {
+		environments.push_back(environmentFactory());
+	}
+	if(numOfThreads == 0) {
+		numOfThreads = std::thread::hardware_concurrency();
+	}
+	// More threads than instances would only idle. 
+	numOfThreads = Maths::clamp(numOfThreads, 1U, numOfEnvironments);
+	workerPool = new WorkerPool(numOfThreads);
+}
+
+VectorEnvironment::~VectorEnvironment() {
+	delete workerPool;
+	for(Environment* environment : environments) {
+		delete environment;
+	}
+	environments.clear();
+}
+
+uint32_t VectorEnvironment::maxNumOfAgents() {
+	return static_cast<uint32_t>(environments.size());
+}
+
+bool VectorEnvironment::onlyFinalReward() {
+	return environments[0]->onlyFinalReward();
+}
+
+void VectorEnvironment::reset(uint32_t numOfAgents) {
+	// Every instance is played by a single agent. 
+	workerPool->runBatch(static_cast<uint32_t>(environments.size()), [this](uint32_t i) {
+		environments[i]->reset(1);
+	});
+}
+
+void VectorEnvironment::update() {
+	workerPool->runBatch(static_cast<uint32_t>(environments.size()), [this](uint32_t i) {
+		// Reset instances which reached game over during the last tick. 
+		if(environments[i]->gameOver()) {
+			environments[i]->reset(1);
+		}
+		environments[i]->update();
+	});
+}
+
+void VectorEnvironment::getInputData(AGENT_ID agentID, std::vector<float>& data) {
+	environments[agentID]->getInputData(0, data);
+}
+
+float VectorEnvironment::getActionMax() {
+	return environments[0]->getActionMax();
+}
+
+void VectorEnvironment::onAction(AGENT_ID agentID, float action) {
+	environments[agentID]->onAction(0, action);
+}
+
+float VectorEnvironment::rewardAgent(AGENT_ID agentID) {
+	return environments[agentID]->rewardAgent(0);
+}
+
+bool VectorEnvironment::gameOver() {
+	return false;	// Instances are reset on their own, see "agentGameOver". 
+}
+
+void VectorEnvironment::getInputDataBatch(uint32_t numOfAgents, std::vector<float>& data) {
+	// Every instance writes into its own scratch buffer and row of "data". 
+	workerPool->runBatch(numOfAgents, [this, &data](uint32_t agentID) {
+		environments[agentID]->getInputData(0, inputDatas[agentID]);
+		std::copy(inputDatas[agentID].begin(), inputDatas[agentID].end(), data.begin() + agentID * LSTM_INPUT_SIZE);
+	});
+}
+
+void VectorEnvironment::onActions(const std::vector<AGENT_ID>& agentIDs, const std::vector<float>& actions) {
+	workerPool->runBatch(static_cast<uint32_t>(agentIDs.size()), [this, &agentIDs, &actions](uint32_t i) {
+		environments[agentIDs[i]]->onAction(0, actions[i]);
+	});
+}
+
+bool VectorEnvironment::agentGameOver(AGENT_ID agentID) {
+	return environments[agentID]->gameOver();
+}
+
+uint32_t VectorEnvironment::getNumOfEnvironments() const {
+	return static_cast<uint32_t>(environments.size());
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+
+#include "Environment.h"
+#include "util/WorkerPool.h"
+
+namespace PLANS {
+
+	//############################ VectorEnvironment ############################
+
+	/*
+	*	Owns several independent instances of an environment (e.g. one ALE per EnvironmentBreakout) and steps all of them per tick. 
+	*		- Every instance is played by exactly one agent, the agent ID equals the index of the instance. 
+	*		- Instances which reached game over are reset automatically on the next update. Until then "agentGameOver" returns true for their agent. 
+	*		- The vector as a whole never reaches game over, so episodes only end per instance or when the maximum episode length is reached. 
+	*		- Resets, updates, actions and input data of the instances are processed concurrently by a WorkerPool. 
+	*/
+	class VectorEnvironment : public Environment {
+		public:
+			// Creates a new single-agent environment instance. 
+			using EnvironmentFactory = std::function<Environment*()>;
+
+			// "numOfThreads" is passed to the WorkerPool (0 = one thread per hardware thread) and capped at "numOfEnvironments". 
+			VectorEnvironment(uint32_t numOfEnvironments, uint32_t numOfThreads, const EnvironmentFactory& environmentFactory);
+			virtual ~VectorEnvironment();
+
+			virtual uint32_t maxNumOfAgents() final override;
+			virtual bool onlyFinalReward() final override;
+			virtual void reset(uint32_t numOfAgents) final override;
+			virtual void update() final override;
+			virtual void getInputData(AGENT_ID agentID, std::vector<float>& data) final override;
+			virtual float getActionMax() final override;
+			virtual void onAction(AGENT_ID agentID, float action) final override;
+			virtual float rewardAgent(AGENT_ID agentID) final override;
+			virtual bool gameOver() final override;
+			virtual void getInputDataBatch(uint32_t numOfAgents, std::vector<float>& data) final override;
+			virtual void onActions(const std::vector<AGENT_ID>& agentIDs, const std::vector<float>& actions) final override;
+			virtual bool agentGameOver(AGENT_ID agentID) final override;
+
+			uint32_t getNumOfEnvironments() const;
+		protected:
+		private:
+			std::vector<Environment*> environments;
+			std::vector<std::vector<float>> inputDatas;	// Scratch buffers for the input data, one per instance. 
+			WorkerPool* workerPool;
+	};
+
+}
@@ -0,0 +1,168 @@
+#include "CheckpointIndex.h"
+
+#include <algorithm>
+#include <set>
+#include <fstream>
+#include <filesystem>
+#include <JSON/json.hpp>
+
+#include "DeltaCheckpointFormat.h"
+#include "../util/StringUtils.h"
+#include "../util/IOUtils.h"
+
+using namespace PLANS;
+using namespace AEX;
+using json = nlohmann::json;
+
+//############################ CheckpointIndex ############################
+
+// PUBLIC
+
+CheckpointIndex::CheckpointIndex(const std::string& directory, const std::string& modelName, uint32_t keepLast, uint32_t keepEvery) : directory(directory), modelName(modelName), keepLast(keepLast), keepEvery(keepEvery), entries() {}
+
+bool CheckpointIndex::load() {
+	entries.clear();
+	std::filesystem::path filePath = std::filesystem::u8path(getFilePath());
+	if(!std::filesystem::is_regular_file(filePath)) {
+		return false;
+	}
+	try {
+		std::ifstream stream(filePath);
+		json data = json::parse(stream);
+		if(data["version"].get<uint32_t>() > CHECKPOINT_INDEX_VERSION) {
+			return false;
+		}
+		for(const json& checkpoint : data["checkpoints"]) {
+			entries.push_back(CheckpointIndexEntry { checkpoint["file"].get<std::string>(), checkpoint["episode"].get<uint32_t>(), checkpoint["size"].get<uint64_t>(), checkpoint.value("base", "") });
+		}
+	} catch(std::exception&) {
+		// Damaged index. 
+		entries.clear();
+		return false;
+	}
+	sort();
+	return true;
+}
+
+void CheckpointIndex::save() const {
+	json data = json::object();
+	data["version"] = CHECKPOINT_INDEX_VERSION;
+	data["latest"] = entries.empty() ? "" : entries.back().fileName;
+	data["checkpoints"] = json::array();
+	for(const CheckpointIndexEntry& entry : entries) {
+		json checkpoint = { { "file", entry.fileName }, { "episode", entry.episode }, { "size", entry.size } };
+		if(!entry.baseFileName.empty()) {
+			checkpoint["base"] = entry.baseFileName;
+		}
+		data["checkpoints"].push_back(checkpoint);
+	}
+	// Replace the index at once. 
+	std::string filePath = getFilePath();
+	IOUtils::writeStringToFile(filePath + ".tmp", true, data.dump(4));
+	std::filesystem::rename(std::filesystem::u8path(filePath + ".tmp"), std::filesystem::u8path(filePath));
+}
+
+void CheckpointIndex::rebuild() {
+	entries.clear();
+	DirectoryIterator directoryIterator = IOUtils::getDirectoryIterator(directory + "/");
+	uint32_t episode;
+	for(const DirectoryEntry entry : directoryIterator) {
+		if(entry.isDirectory) {
+			continue;	// Ignore directories. 
+		}
+		episode = parseEpisode(entry.name);
+		if(episode == UINT32_MAX) {
+			continue;
+		}
+		entries.push_back(CheckpointIndexEntry { entry.name, episode, IOUtils::getFileSize(entry.filename), DeltaCheckpointFormat::getBaseFileName(entry.filename) });
+	}
+	sort();
+}
+
+void CheckpointIndex::add(const std::string& fileName, uint32_t episode, uint64_t size, const std::string& baseFileName) {
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [&fileName](const CheckpointIndexEntry& entry) { return entry.fileName == fileName; }), entries.end());
+	entries.push_back(CheckpointIndexEntry { fileName, episode, size, baseFileName });
+	sort();
+}
+
+void CheckpointIndex::applyRetention() {
+	if(keepLast == 0) {
+		return;	// Keep all. 
+	}
+	// Determine the retained checkpoints and their bases. 
+	std::vector<bool> retained = std::vector<bool>(entries.size(), false);
+	std::set<std::string> requiredBases;
+	for(size_t i = 0; i < entries.size(); i++) {
+		retained[i] = i + keepLast >= entries.size() || (keepEvery > 0 && entries[i].episode % keepEvery == 0);
+		if(retained[i] && !entries[i].baseFileName.empty()) {
+			requiredBases.insert(entries[i].baseFileName);
+		}
+	}
+	std::vector<CheckpointIndexEntry> retainedEntries;
+	for(size_t i = 0; i < entries.size(); i++) {
+		const CheckpointIndexEntry& entry = entries[i];
+		if(retained[i] || requiredBases.count(entry.fileName) > 0) {
+			retainedEntries.push_back(entry);
+			continue;
+		}
+		std::error_code error;
+		std::filesystem::path filePath = std::filesystem::u8path(directory + "/" + entry.fileName);
+		if(!std::filesystem::remove(filePath, error) && error) {
+			retainedEntries.push_back(entry);	// Still in use, try again next time. 
+		}
+	}
+	entries = retainedEntries;
+}
+
+const CheckpointIndexEntry* CheckpointIndex::getLatest() const {
+	if(entries.empty()) {
+		return nullptr;
+	}
+	return &entries.back();
+}
+
+const std::vector<CheckpointIndexEntry>& CheckpointIndex::getEntries() const {
+	return entries;
+}
+
+std::string CheckpointIndex::getFilePath() const {
+	return directory + "/" + modelName + ".index.json";
+}
+
+// PRIVATE
+
+uint32_t CheckpointIndex::parseEpisode(const std::string& fileName) const {
+	if(IOUtils::getFileExtension(fileName) != CHECKPOINT_FILE_EXTENSION) {
+		return UINT32_MAX;	// Wrong file extension. 
+	}
+	std::string splitParts[2];
+	uint32_t splitCount = StringUtils::split(fileName, "_", splitParts, 2);
+	std::string tmpString;
+	// Check for correct model name. 
+	if(splitCount == 1) {
+		tmpString = splitParts[0];
+		StringUtils::replace(tmpString, CHECKPOINT_FILE_EXTENSION, "");
+		if(tmpString != modelName) {
+			return UINT32_MAX;	// Wrong model name. 
+		}
+	} else if(splitCount == 2 && splitParts[0] != modelName) {
+		return UINT32_MAX;	// Wrong model name. 
+	}
+	// Check for episode in file name. If there is none, assume episode 0. 
+	if(!StringUtils::startsWith(splitParts[1], "episode") || !StringUtils::endsWith(splitParts[1], CHECKPOINT_FILE_EXTENSION)) {
+		return 0;
+	}
+	tmpString = splitParts[1];
+	StringUtils::replace(tmpString, "episode", "");
+	StringUtils::replace(tmpString, CHECKPOINT_FILE_EXTENSION, "");
+	try {
+		return static_cast<uint32_t>(std::stoi(tmpString));
+	} catch(std::exception&) {
+		// Not just a number, also letters. Can't parse the episode. 
+		return UINT32_MAX;
+	}
+}
+
+void CheckpointIndex::sort() {
+	std::stable_sort(entries.begin(), entries.end(), [](const CheckpointIndexEntry& a, const CheckpointIndexEntry& b) { return a.episode < b.episode; });
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PLANS {
+
+	static const std::string CHECKPOINT_FILE_EXTENSION = ".checkpoint";
+	constexpr uint32_t CHECKPOINT_INDEX_VERSION = 1;
+
+	//############################ CheckpointIndexEntry ############################
+
+	struct CheckpointIndexEntry {
+		std::string fileName;	// Relative to the checkpoint directory. 
+		uint32_t episode;
+		uint64_t size;			// In bytes. 
+		std::string baseFileName;	// Base of a delta checkpoint (see DeltaCheckpoint), empty for full checkpoints. 
+	};
+
+	//############################ CheckpointIndex ############################
+
+	/*
+	*	Index of the checkpoints of a model, stored as "<model name>.index.json" in the checkpoint directory. 
+	*		- Lists every checkpoint with its episode and size, so the latest checkpoint is found without scanning the directory. 
+	*		- Saved to "<index>.tmp" first and renamed afterwards, so the index file is always complete. 
+	*		- Retention: The last "keepLast" checkpoints and every checkpoint whose episode is a multiple of "keepEvery" are kept, the other ones are deleted. 
+	*		  "keepLast" 0 keeps all checkpoints, "keepEvery" 0 keeps none besides the last ones. Bases of kept delta checkpoints are always kept. 
+	*/
+	class CheckpointIndex {
+		public:
+			CheckpointIndex(const std::string& directory, const std::string& modelName, uint32_t keepLast, uint32_t keepEvery);
+
+			// Returns false, if there is no valid index file. 
+			bool load();
+			void save() const;
+			// Recreates the index from the checkpoint files in the directory (slow). Used for directories without index. 
+			void rebuild();
+
+			// Adds a checkpoint or replaces the entry of the same file. 
+			void add(const std::string& fileName, uint32_t episode, uint64_t size, const std::string& baseFileName);
+			// Deletes the checkpoints which aren't retained. Files which can't be deleted (e.g. still mapped on Windows) stay listed and are retried next time. 
+			void applyRetention();
+
+			// Returns nullptr, if there is no checkpoint. 
+			const CheckpointIndexEntry* getLatest() const;
+			const std::vector<CheckpointIndexEntry>& getEntries() const;
+			std::string getFilePath() const;
+		protected:
+		private:
+			std::string directory;
+			std::string modelName;
+			uint32_t keepLast;
+			uint32_t keepEvery;
+			std::vector<CheckpointIndexEntry> entries;	// Sorted by episode. 
+
+			// Returns UINT32_MAX, if the file name isn't a checkpoint of the model. 
+			uint32_t parseEpisode(const std::string& fileName) const;
+			void sort();
+	};
+
+}
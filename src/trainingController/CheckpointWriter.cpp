@@ -0,0 +1,214 @@
+#include "CheckpointWriter.h"
+
+#include <iostream>
+#include <filesystem>
+
+#include "MappedCheckpoint.h"
+#include "DeltaCheckpoint.h"
+#include "ScriptedPolicy.h"
+#include "../TrainingParameters.h"
+#include "../util/Maths.h"
+#include "../util/IOUtils.h"
+#include "../util/compression/GZip.h"
+
+using namespace PLANS;
+using namespace AEX;
+
+//############################ PolicySnapshot ############################
+
+// Copies the model on the training device. 
+static Model* copyModel(Model* sourceModel) {
+	torch::NoGradGuard noGrad;
+
+	Model* model = new Model(STD);
+#ifdef USE_CUDA
+	model->get()->toDevice(torch::kCUDA);
+#else
+	model->get()->toDevice(torch::kCPU);
+#endif
+	std::vector<torch::Tensor> source = sourceModel->get()->parameters();
+	std::vector<torch::Tensor> target = model->get()->parameters();
+	for(size_t i = 0; i < source.size(); i++) {
+		target[i].copy_(source[i]);
+	}
+	source = sourceModel->get()->buffers();
+	target = model->get()->buffers();
+	for(size_t i = 0; i < source.size(); i++) {
+		target[i].copy_(source[i]);
+	}
+	return model;
+}
+
+PolicySnapshot::PolicySnapshot(Model* sourceModel, Optimizer* sourceOptimizer) : model(copyModel(sourceModel)), optimizerState() {
+	serializeOptimizer(sourceOptimizer, optimizerState);
+}
+
+PolicySnapshot::PolicySnapshot(Model* sourceModel, const std::vector<int8_t>& sourceOptimizerState) : model(copyModel(sourceModel)), optimizerState(sourceOptimizerState) {}
+
+PolicySnapshot::~PolicySnapshot() {
+	delete model;
+}
+
+void PolicySnapshot::serializeOptimizer(const Optimizer* optimizer, std::vector<int8_t>& data) {
+	data.clear();
+	std::function<size_t(const void*, size_t)> writer = [&data](const void* buffer, size_t size) -> size_t {
+		const int8_t* bytes = static_cast<const int8_t*>(buffer);
+		data.insert(data.end(), bytes, bytes + size);
+		return size;
+	};
+	torch::save(*optimizer, writer);
+}
+
+//############################ CheckpointWriter ############################
+
+// PUBLIC
+
+CheckpointWriter::CheckpointWriter(const TrainingParameters* params) : maxPendingCheckpoints(Maths::max<uint32_t>(params->maxPendingCheckpoints, 1)), compressionLevel(params->checkpointCompressionLevel), compressionThreads(params->checkpointCompressionThreads), streaming(params->checkpointStreaming), mapped(params->checkpointMapped), deltaInterval(params->checkpointDeltaInterval), deltaBaseFilePath(), checkpointsSinceBase(0), checkpointDirectory("./" + params->checkpointDirectoryName), exportFilePath(params->exportScriptedPolicy ? "./" + params->checkpointDirectoryName + "/" + params->modelNameLoad : ""), index(checkpointDirectory, params->modelNameLoad, params->checkpointKeepLast, params->checkpointKeepEvery), indexMutex(), writerThread(), mutex(), condition(), pendingJobs(), stopping(false) {
+	// Directories without (valid) index are scanned once. 
+	const CheckpointIndexEntry* latest = nullptr;
+	if(!index.load() || ((latest = index.getLatest()) != nullptr && !IOUtils::exists(checkpointDirectory + "/" + latest->fileName))) {
+		index.rebuild();
+		index.save();
+	}
+	writerThread = std::thread(&CheckpointWriter::writerLoop, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+	// Pending checkpoints are finished first. 
+	mutex.lock();
+	stopping = true;
+	mutex.unlock();
+	condition.notify_all();
+	writerThread.join();
+}
+
+void CheckpointWriter::write(const std::string& checkpointFilePath, uint32_t episode, const std::vector<PolicySnapshot*>& snapshots) {
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this]() { return pendingJobs.size() < maxPendingCheckpoints; });
+	pendingJobs.push_back(CheckpointJob { checkpointFilePath, episode, snapshots });
+	lock.unlock();
+	condition.notify_all();
+}
+
+void CheckpointWriter::flush() {
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this]() { return pendingJobs.empty(); });
+}
+
+bool CheckpointWriter::getLatestCheckpoint(std::string& checkpointFilePath, uint32_t& episode) {
+	std::lock_guard<std::mutex> lock(indexMutex);
+	const CheckpointIndexEntry* latest = index.getLatest();
+	if(latest == nullptr) {
+		return false;
+	}
+	checkpointFilePath = checkpointDirectory + "/" + latest->fileName;
+	episode = latest->episode;
+	return true;
+}
+
+void CheckpointWriter::serializePolicy(Model* model, const std::vector<int8_t>& optimizerState, Serializer& serializer) {
+	// Let the torch archive write into a memory buffer, as the size has to be known before the data. 
+	std::vector<int8_t> data;
+	std::function<size_t(const void*, size_t)> writer = [&data](const void* buffer, size_t size) -> size_t {
+		const int8_t* bytes = static_cast<const int8_t*>(buffer);
+		data.insert(data.end(), bytes, bytes + size);
+		return size;
+	};
+
+	torch::save(*model, writer);
+	serializer.serialize(static_cast<uint64_t>(data.size()));
+	serializer.serialize(data.data(), data.size());
+
+	serializer.serialize(static_cast<uint64_t>(optimizerState.size()));
+	serializer.serialize(optimizerState.data(), optimizerState.size());
+}
+
+// PRIVATE
+
+void CheckpointWriter::writerLoop() {
+	while(true) {
+		// Wait for a checkpoint. 
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [this]() { return stopping || !pendingJobs.empty(); });
+		if(pendingJobs.empty()) {
+			return;	// Stopping and nothing left to write. 
+		}
+		const CheckpointJob& job = pendingJobs.front();	// Only popped by this thread, so the reference stays valid. 
+		lock.unlock();
+
+		try {
+			std::string baseFileName = writeCheckpoint(job);
+			updateIndex(job, baseFileName);
+		} catch(std::exception& e) {
+			std::cerr << "CheckpointWriter::writerLoop: Failed to write checkpoint \"" + job.checkpointFilePath + "\": " + e.what() << std::endl;
+		}
+		if(!exportFilePath.empty()) {
+			// The checkpoint is valid even if the export fails (e.g. for models which can't be traced). 
+			try {
+				exportPolicies(job);
+			} catch(std::exception& e) {
+				std::cerr << "CheckpointWriter::writerLoop: Failed to export the policies of checkpoint \"" + job.checkpointFilePath + "\": " + e.what() << std::endl;
+			}
+		}
+		for(PolicySnapshot* snapshot : job.snapshots) {
+			delete snapshot;
+		}
+
+		lock.lock();
+		pendingJobs.pop_front();
+		lock.unlock();
+		condition.notify_all();
+	}
+}
+
+std::string CheckpointWriter::writeCheckpoint(const CheckpointJob& job) {
+	// Write to a temporary file first, then replace the final checkpoint file at once. 
+	std::string tmpFilePath = job.checkpointFilePath + ".tmp";
+	// A delta needs its base, which must not be replaced by the delta itself. 
+	bool delta = deltaInterval > 0 && checkpointsSinceBase < deltaInterval && !deltaBaseFilePath.empty() && deltaBaseFilePath != job.checkpointFilePath && IOUtils::exists(deltaBaseFilePath);
+	if(delta) {
+		DeltaCheckpoint::write(tmpFilePath, deltaBaseFilePath, job.snapshots, compressionLevel, compressionThreads);
+	} else if(mapped || deltaInterval > 0) {
+		MappedCheckpoint::write(tmpFilePath, job.snapshots);
+	} else if(streaming) {
+		// Only the serializer buffer and the currently serialized model or optimizer are held in memory. 
+		FileOutputSink fileSink(tmpFilePath, true);
+		GZipOutputSink gzipSink(&fileSink, Maths::max<uint32_t>(compressionLevel, 1));
+		Serializer serializer = Serializer(&gzipSink);
+		for(PolicySnapshot* snapshot : job.snapshots) {
+			serializePolicy(snapshot->model, snapshot->optimizerState, serializer);
+		}
+		serializer.finish();
+	} else {
+		Serializer serializer = Serializer();
+		for(PolicySnapshot* snapshot : job.snapshots) {
+			serializePolicy(snapshot->model, snapshot->optimizerState, serializer);
+		}
+		IOUtils::writeBlockCompressedBytesToFile(tmpFilePath, true, serializer.getSerializedData(), serializer.getDataLength(), compressionLevel, compressionThreads);
+	}
+	std::filesystem::rename(std::filesystem::u8path(tmpFilePath), std::filesystem::u8path(job.checkpointFilePath));
+
+	// Remember the base. 
+	if(delta) {
+		checkpointsSinceBase++;
+		return IOUtils::getFileName(deltaBaseFilePath);
+	}
+	if(deltaInterval > 0) {
+		deltaBaseFilePath = job.checkpointFilePath;
+		checkpointsSinceBase = 1;
+	}
+	return "";
+}
+
+void CheckpointWriter::updateIndex(const CheckpointJob& job, const std::string& baseFileName) {
+	std::lock_guard<std::mutex> lock(indexMutex);
+	index.add(IOUtils::getFileName(job.checkpointFilePath), job.episode, IOUtils::getFileSize(job.checkpointFilePath), baseFileName);
+	index.applyRetention();
+	index.save();
+}
+
+void CheckpointWriter::exportPolicies(const CheckpointJob& job) {
+	for(uint32_t p = 0; p < job.snapshots.size(); p++) {
+		ScriptedPolicy::write(exportFilePath + (p > 0 ? "_policy" + std::to_string(p) : "") + SCRIPTED_POLICY_FILE_EXTENSION, job.snapshots[p]->model);
+	}
+}
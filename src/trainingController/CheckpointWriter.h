@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "TrainingController.h"
+#include "CheckpointIndex.h"
+
+namespace PLANS {
+
+	//############################ PolicySnapshot ############################
+
+	/*
+	*	Independent copy of a model (weights and buffers) and the state of its optimizer. 
+	*	Created on the training thread, so the copied policy can be trained on while the snapshot is written. 
+	*	The optimizer state is kept serialized via torch::save, which maps the state onto the parameters by their order. 
+	*/
+	struct PolicySnapshot {
+		Model* model;
+		std::vector<int8_t> optimizerState;
+
+		PolicySnapshot(Model* sourceModel, Optimizer* sourceOptimizer);
+		// Takes the optimizer state serialized by "serializeOptimizer" before. 
+		PolicySnapshot(Model* sourceModel, const std::vector<int8_t>& sourceOptimizerState);
+		~PolicySnapshot();
+
+		// Replaces "data" with the optimizer serialized via torch::save. 
+		static void serializeOptimizer(const Optimizer* optimizer, std::vector<int8_t>& data);
+	};
+
+	//############################ CheckpointWriter ############################
+
+	/*
+	*	Writes checkpoints on a background thread. 
+	*		- The policies are given as snapshots, serialization, compression and writing happen on the writer thread. 
+	*		- Checkpoints are block compressed (see AEX::BlockCompressor), the blocks are compressed in parallel. 
+	*		- In streaming mode, checkpoints are serialized directly into a gzip compressed file instead, so they are never held in memory as a whole. 
+	*		- In mapped mode, checkpoints are written uncompressed as MappedCheckpoint, which loads without reading the whole file. 
+	*		- In delta mode, every "checkpointDeltaInterval"-th checkpoint is written as MappedCheckpoint (base), the ones in between as DeltaCheckpoint against the latest base. 
+	*		- A checkpoint is written to "<path>.tmp" first and renamed afterwards, so a checkpoint file is either complete or doesn't exist. 
+	*		- At most "maxPendingCheckpoints" checkpoints are in flight, "write" blocks while this limit is reached. 
+	*		- Pending checkpoints are finished on destruction. 
+	*		- Written checkpoints are added to the CheckpointIndex of the model, which also deletes old checkpoints according to the retention parameters. 
+	*		- If enabled, the policies of every written checkpoint are also exported as ScriptedPolicy ("<model name>[_policy<index>].pt", replaced by every checkpoint). 
+	*/
+	class CheckpointWriter {
+		public:
+			// Uses the checkpoint parameters (TrainingParameters::maxPendingCheckpoints and TrainingParameters::checkpoint*). 
+			explicit CheckpointWriter(const TrainingParameters* params);
+			~CheckpointWriter();
+
+			// Queues a checkpoint containing the given snapshots (in this order). Takes ownership of the snapshots. 
+			void write(const std::string& checkpointFilePath, uint32_t episode, const std::vector<PolicySnapshot*>& snapshots);
+			// Blocks until all queued checkpoints are written. 
+			void flush();
+			// Returns false, if there is no checkpoint of the model. 
+			bool getLatestCheckpoint(std::string& checkpointFilePath, uint32_t& episode);
+
+			// Serializes model and optimizer state (see PolicySnapshot) in memory. Each of them is prefixed with its size in bytes. 
+			static void serializePolicy(Model* model, const std::vector<int8_t>& optimizerState, AEX::Serializer& serializer);
+		protected:
+		private:
+			struct CheckpointJob {
+				std::string checkpointFilePath;
+				uint32_t episode;
+				std::vector<PolicySnapshot*> snapshots;
+			};
+
+			uint32_t maxPendingCheckpoints;
+			uint32_t compressionLevel;
+			uint32_t compressionThreads;
+			bool streaming;
+			bool mapped;
+			uint32_t deltaInterval;
+			std::string deltaBaseFilePath;	// Latest base, empty if none has been written yet. Only accessed by the writer thread. 
+			uint32_t checkpointsSinceBase;	// Including the base. 
+			std::string checkpointDirectory;
+			std::string exportFilePath;		// Path of the exported policies without extension, empty if disabled. 
+			CheckpointIndex index;
+			std::mutex indexMutex;
+			std::thread writerThread;
+			std::mutex mutex;
+			std::condition_variable condition;
+			std::deque<CheckpointJob> pendingJobs;	// The front job is being written, it is removed once done. 
+			bool stopping;
+
+			void writerLoop();
+			// Returns the file name of the base, if a delta checkpoint has been written. 
+			std::string writeCheckpoint(const CheckpointJob& job);
+			void updateIndex(const CheckpointJob& job, const std::string& baseFileName);
+			// Traces the snapshot models on the training device (the forward pass allocates its tensors there), so the exported policies run on that device. 
+			void exportPolicies(const CheckpointJob& job);
+	};
+
+}
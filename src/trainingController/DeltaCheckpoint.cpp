@@ -0,0 +1,151 @@
+#include "DeltaCheckpoint.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include "MappedCheckpoint.h"
+#include "../util/Maths.h"
+#include "../util/IOUtils.h"
+#include "../util/Streams.h"
+#include "../util/compression/BlockCompression.h"
+
+using namespace PLANS;
+using namespace AEX;
+
+//############################ DeltaCheckpoint ############################
+
+// PUBLIC
+
+DeltaCheckpoint::DeltaCheckpoint(const std::string& filePath, uint32_t numOfThreads) : policies(), tensorIndices() {
+	// Read header. The file data is owned by the deserializer. 
+	uint64_t dataSize = 0;
+	int8_t* data = IOUtils::readBytesFromFile(filePath, dataSize);
+	Deserializer deserializer = Deserializer(data, dataSize, 0, true);
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	std::string baseFileName;
+	uint64_t payloadSize = 0;
+	int8_t* payload = nullptr;
+	deserializer.deserialize(magic);
+	deserializer.deserialize(version);
+	if(magic != DELTA_CHECKPOINT_MAGIC || version > DELTA_CHECKPOINT_VERSION) {
+		throw io_error("Not a delta checkpoint or unsupported version! Filename: " + filePath);
+	}
+	deserializer.deserialize(baseFileName);
+	deserializer.deserialize(payloadSize);
+	deserializer.deserialize(payload, payloadSize);
+
+	// Decompress payload. 
+	uint64_t rawSize = 0;
+	int8_t* rawData = BlockDecompressor(numOfThreads).decompress(payload, payloadSize, rawSize);
+	Deserializer payloadDeserializer = Deserializer(rawData, rawSize, 0, true);
+
+	// Reconstruct the tensors from the base. 
+	std::string baseFilePath = (std::filesystem::u8path(filePath).parent_path() / std::filesystem::u8path(baseFileName)).u8string();
+	MappedCheckpoint base = MappedCheckpoint(baseFilePath);
+	uint32_t numOfPolicies = 0;
+	uint32_t numOfTensors = 0;
+	std::string name;
+	int32_t scalarType = 0;
+	std::vector<int64_t> sizes;
+	uint8_t encoding = 0;
+	uint64_t size = 0;
+	int8_t* tensorData = nullptr;
+	payloadDeserializer.deserialize(numOfPolicies);
+	policies.resize(numOfPolicies);
+	tensorIndices.resize(numOfPolicies);
+	for(uint32_t p = 0; p < numOfPolicies; p++) {
+		payloadDeserializer.deserialize(numOfTensors);
+		for(uint32_t t = 0; t < numOfTensors; t++) {
+			payloadDeserializer.deserialize(name);
+			payloadDeserializer.deserialize(scalarType);
+			payloadDeserializer.deserialize(sizes);
+			payloadDeserializer.deserialize(encoding);
+			payloadDeserializer.deserialize(size);
+			payloadDeserializer.deserialize(tensorData, size);
+			torch::Tensor tensor = torch::empty(sizes, torch::TensorOptions().device(torch::kCPU).dtype(static_cast<torch::ScalarType>(scalarType)));
+			if(static_cast<uint64_t>(tensor.numel()) * tensor.element_size() != size) {
+				throw io_error("Size of tensor \"" + name + "\" doesn't match its shape! Filename: " + filePath);
+			}
+			if(encoding == XOR_BASE) {
+				torch::Tensor baseTensor = p < base.getNumOfPolicies() ? base.getTensor(p, name) : torch::Tensor();
+				if(!baseTensor.defined() || static_cast<uint64_t>(baseTensor.numel()) * baseTensor.element_size() != size) {
+					throw io_error("Tensor \"" + name + "\" is missing in the base \"" + baseFilePath + "\"!");
+				}
+				DeltaCheckpointFormat::decode(tensorData, static_cast<const int8_t*>(baseTensor.data_ptr()), static_cast<int8_t*>(tensor.data_ptr()), static_cast<uint64_t>(tensor.numel()), static_cast<uint32_t>(tensor.element_size()));
+			} else {
+				std::memcpy(tensor.data_ptr(), tensorData, size);
+			}
+			tensorIndices[p][name] = policies[p].size();
+			policies[p].emplace_back(name, tensor);
+		}
+	}
+}
+
+void DeltaCheckpoint::write(const std::string& filePath, const std::string& baseFilePath, const std::vector<PolicySnapshot*>& snapshots, uint32_t level, uint32_t numOfThreads) {
+	MappedCheckpoint base = MappedCheckpoint(baseFilePath);
+
+	// Encode the tensors against the base. 
+	Serializer payload = Serializer();
+	PolicyTensors tensors;
+	std::vector<int8_t> encodedData;
+	payload.serialize(static_cast<uint32_t>(snapshots.size()));
+	for(uint32_t p = 0; p < snapshots.size(); p++) {
+		tensors.clear();
+		collectTensors(snapshots[p]->model, snapshots[p]->optimizerState, tensors);
+		payload.serialize(static_cast<uint32_t>(tensors.size()));
+		for(const std::pair<std::string, torch::Tensor>& tensor : tensors) {
+			uint64_t size = static_cast<uint64_t>(tensor.second.numel()) * tensor.second.element_size();
+			torch::Tensor baseTensor = p < base.getNumOfPolicies() ? base.getTensor(p, tensor.first) : torch::Tensor();
+			bool xorBase = baseTensor.defined() && baseTensor.sizes() == tensor.second.sizes() && baseTensor.scalar_type() == tensor.second.scalar_type();
+			payload.serialize(tensor.first);
+			payload.serialize(static_cast<int32_t>(tensor.second.scalar_type()));
+			payload.serialize(tensor.second.sizes().vec());
+			payload.serialize(static_cast<uint8_t>(xorBase ? XOR_BASE : RAW));
+			payload.serialize(size);
+			if(xorBase) {
+				encodedData.resize(size);
+				DeltaCheckpointFormat::encode(static_cast<const int8_t*>(tensor.second.data_ptr()), static_cast<const int8_t*>(baseTensor.data_ptr()), encodedData.data(), static_cast<uint64_t>(tensor.second.numel()), static_cast<uint32_t>(tensor.second.element_size()));
+				payload.serialize(encodedData.data(), size);
+			} else {
+				payload.serialize(static_cast<const int8_t*>(tensor.second.data_ptr()), size);
+			}
+		}
+	}
+
+	// Compress and write. At least level 1, as the XORed data is mostly zeros. 
+	uint64_t compressedSize = 0;
+	int8_t* compressedData = BlockCompressor(Maths::max<uint32_t>(level, 1), numOfThreads).compress(payload.getSerializedData(), payload.getDataLength(), compressedSize);
+	try {
+		FileOutputSink fileSink(filePath, true);
+		Serializer serializer = Serializer(&fileSink);
+		serializer.serialize(DELTA_CHECKPOINT_MAGIC);
+		serializer.serialize(DELTA_CHECKPOINT_VERSION);
+		serializer.serialize(IOUtils::getFileName(baseFilePath));
+		serializer.serialize(compressedSize);
+		serializer.serialize(compressedData, compressedSize);
+		serializer.finish();
+	} catch(...) {
+		delete[] compressedData;
+		throw;
+	}
+	delete[] compressedData;
+}
+
+void DeltaCheckpoint::reconstruct(const std::string& filePath, const std::string& targetFilePath, uint32_t numOfThreads) {
+	DeltaCheckpoint checkpoint = DeltaCheckpoint(filePath, numOfThreads);
+	MappedCheckpoint::write(targetFilePath, checkpoint.policies);
+}
+
+uint32_t DeltaCheckpoint::getNumOfPolicies() const {
+	return static_cast<uint32_t>(policies.size());
+}
+
+torch::Tensor DeltaCheckpoint::getTensor(uint32_t policyIndex, const std::string& name) const {
+	std::map<std::string, size_t>::const_iterator it = tensorIndices[policyIndex].find(name);
+	if(it == tensorIndices[policyIndex].end()) {
+		return torch::Tensor();
+	}
+	return policies[policyIndex][it->second].second;
+}
+
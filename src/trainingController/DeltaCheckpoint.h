@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "CheckpointWriter.h"
+#include "TensorCheckpoint.h"
+#include "DeltaCheckpointFormat.h"
+
+namespace PLANS {
+
+	//############################ DeltaCheckpoint ############################
+
+	/*
+	*	Checkpoint, which only stores the difference of its tensors to a base checkpoint (MappedCheckpoint in the same directory). 
+	*		- Layout: header (magic, version, base file name, payload size), block compressed payload (see AEX::BlockCompressor). 
+	*		- The payload lists name, type, sizes, encoding and data of every tensor of every policy. 
+	*		- Tensors are XORed bytewise with the tensor of the same name in the base and the bytes are grouped by their position in the element (see DeltaCheckpointFormat::encode). 
+	*		  Weights which changed modestly keep sign, exponent and the high mantissa bits, so these bytes become zero and compress well. The encoding is lossless. 
+	*		- Tensors without counterpart in the base (e.g. the optimizer state of a parameter stepped for the first time) are stored as they are. 
+	*		- Loading reconstructs all tensors in memory, the base has to exist. 
+	*/
+	class DeltaCheckpoint : public TensorCheckpoint {
+		public:
+			// Reads the base, which is expected in the same directory. Decompresses with the given number of threads (0 for one per hardware thread). 
+			explicit DeltaCheckpoint(const std::string& filePath, uint32_t numOfThreads = 0);
+
+			// Writes the policies of the given snapshots (in this order) as difference to the given base. 
+			static void write(const std::string& filePath, const std::string& baseFilePath, const std::vector<PolicySnapshot*>& snapshots, uint32_t level, uint32_t numOfThreads = 0);
+			// Writes the reconstructed policies as full MappedCheckpoint. 
+			static void reconstruct(const std::string& filePath, const std::string& targetFilePath, uint32_t numOfThreads = 0);
+
+			uint32_t getNumOfPolicies() const override;
+			torch::Tensor getTensor(uint32_t policyIndex, const std::string& name) const override;
+		protected:
+		private:
+			enum TensorEncoding : uint8_t {
+				XOR_BASE = 0,
+				RAW = 1
+			};
+
+			std::vector<PolicyTensors> policies;
+			std::vector<std::map<std::string, size_t>> tensorIndices;	// Per policy: name -> index in "policies". 
+	};
+
+}
@@ -0,0 +1,46 @@
+#include "DeltaCheckpointFormat.h"
+
+#include "../util/Streams.h"
+#include "../util/Serialization.h"
+
+using namespace PLANS;
+using namespace AEX;
+
+//############################ DeltaCheckpointFormat ############################
+
+// PUBLIC
+
+void DeltaCheckpointFormat::encode(const int8_t* source, const int8_t* base, int8_t* target, uint64_t numOfElements, uint32_t elementSize) {
+	for(uint64_t i = 0; i < numOfElements; i++) {
+		for(uint32_t b = 0; b < elementSize; b++) {
+			target[b * numOfElements + i] = source[i * elementSize + b] ^ base[i * elementSize + b];
+		}
+	}
+}
+
+void DeltaCheckpointFormat::decode(const int8_t* source, const int8_t* base, int8_t* target, uint64_t numOfElements, uint32_t elementSize) {
+	for(uint64_t i = 0; i < numOfElements; i++) {
+		for(uint32_t b = 0; b < elementSize; b++) {
+			target[i * elementSize + b] = source[b * numOfElements + i] ^ base[i * elementSize + b];
+		}
+	}
+}
+
+std::string DeltaCheckpointFormat::getBaseFileName(const std::string& filePath) {
+	try {
+		FileInputSource fileSource(filePath);
+		Deserializer deserializer = Deserializer(&fileSource, 4096);
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		std::string baseFileName;
+		deserializer.deserialize(magic);
+		if(magic != DELTA_CHECKPOINT_MAGIC) {
+			return "";
+		}
+		deserializer.deserialize(version);
+		deserializer.deserialize(baseFileName);
+		return baseFileName;
+	} catch(std::exception&) {
+		return "";	// Too short or not readable. 
+	}
+}
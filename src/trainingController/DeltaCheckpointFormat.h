@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace PLANS {
+
+	constexpr uint32_t DELTA_CHECKPOINT_MAGIC = 0x544C4450;	// "PDLT". 
+	constexpr uint32_t DELTA_CHECKPOINT_VERSION = 1;
+
+	//############################ DeltaCheckpointFormat ############################
+
+	/*
+	*	Parts of the delta checkpoint format (see DeltaCheckpoint) which don't depend on torch. 
+	*		- "encode" XORs an element array bytewise with its base and groups the bytes by their position in the element (all first bytes, all second bytes, ...). 
+	*		- "getBaseFileName" only reads the header, so checkpoint directories can be indexed without loading tensors (see CheckpointIndex). 
+	*/
+	class DeltaCheckpointFormat {
+		public:
+			// Writes "(source XOR base)" with the bytes grouped by their position in the element. 
+			static void encode(const int8_t* source, const int8_t* base, int8_t* target, uint64_t numOfElements, uint32_t elementSize);
+			// Reverses "encode". 
+			static void decode(const int8_t* source, const int8_t* base, int8_t* target, uint64_t numOfElements, uint32_t elementSize);
+			// Returns the file name of the base or an empty string, if the file isn't a delta checkpoint. 
+			static std::string getBaseFileName(const std::string& filePath);
+		protected:
+		private:
+	};
+
+}
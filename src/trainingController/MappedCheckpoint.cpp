@@ -0,0 +1,144 @@
+#include "MappedCheckpoint.h"
+
+#include <fstream>
+#include <filesystem>
+
+#include "../util/IOUtils.h"
+#include "../util/Streams.h"
+
+using namespace PLANS;
+using namespace AEX;
+
+//############################ MappedCheckpoint ############################
+
+// PUBLIC
+
+MappedCheckpoint::MappedCheckpoint(const std::string& filePath) : file(nullptr), dataOffset(0), policies() {
+	file = std::make_shared<MappedFile>(filePath);
+
+	// Read the table directly from the mapped pages. 
+	Deserializer deserializer = Deserializer(file->getData(), file->getDataSize());
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t tableSize = 0;
+	deserializer.deserialize(magic);
+	deserializer.deserialize(version);
+	deserializer.deserialize(tableSize);
+	if(magic != MAPPED_CHECKPOINT_MAGIC || version > MAPPED_CHECKPOINT_VERSION) {
+		throw io_error("Not a mapped checkpoint or unsupported version! Filename: " + filePath);
+	}
+	dataOffset = align(deserializer.getCurrentOffset() + tableSize);
+
+	uint32_t numOfPolicies = 0;
+	uint32_t numOfTensors = 0;
+	std::string name;
+	deserializer.deserialize(numOfPolicies);
+	policies.resize(numOfPolicies);
+	for(uint32_t p = 0; p < numOfPolicies; p++) {
+		deserializer.deserialize(numOfTensors);
+		for(uint32_t t = 0; t < numOfTensors; t++) {
+			TensorEntry entry = TensorEntry();
+			deserializer.deserialize(name);
+			deserializer.deserialize(entry.scalarType);
+			deserializer.deserialize(entry.sizes);
+			deserializer.deserialize(entry.offset);
+			deserializer.deserialize(entry.size);
+			if(dataOffset + entry.offset + entry.size > file->getDataSize()) {
+				throw io_error("Tensor \"" + name + "\" exceeds the checkpoint! Filename: " + filePath);
+			}
+			policies[p][name] = entry;
+		}
+	}
+}
+
+void MappedCheckpoint::write(const std::string& filePath, const std::vector<PolicySnapshot*>& snapshots) {
+	std::vector<PolicyTensors> policyTensors = std::vector<PolicyTensors>(snapshots.size());
+	for(size_t p = 0; p < snapshots.size(); p++) {
+		collectTensors(snapshots[p]->model, snapshots[p]->optimizerState, policyTensors[p]);
+	}
+	write(filePath, policyTensors);
+}
+
+void MappedCheckpoint::write(const std::string& filePath, const std::vector<PolicyTensors>& policyTensors) {
+
+	// Build the table first, as the tensor data starts behind it. Offsets are relative to the tensor data. 
+	Serializer table = Serializer();
+	std::vector<uint64_t> offsets;
+	uint64_t offset = 0;
+	table.serialize(static_cast<uint32_t>(policyTensors.size()));
+	for(const PolicyTensors& tensors : policyTensors) {
+		table.serialize(static_cast<uint32_t>(tensors.size()));
+		for(const std::pair<std::string, torch::Tensor>& tensor : tensors) {
+			uint64_t size = static_cast<uint64_t>(tensor.second.numel()) * tensor.second.element_size();
+			offset = align(offset);
+			offsets.push_back(offset);
+			table.serialize(tensor.first);
+			table.serialize(static_cast<int32_t>(tensor.second.scalar_type()));
+			table.serialize(tensor.second.sizes().vec());
+			table.serialize(offset);
+			table.serialize(size);
+			offset += size;
+		}
+	}
+
+	// Stream header, table and tensor data into the file. 
+	FileOutputSink fileSink(filePath, true);
+	Serializer serializer = Serializer(&fileSink);
+	serializer.serialize(MAPPED_CHECKPOINT_MAGIC);
+	serializer.serialize(MAPPED_CHECKPOINT_VERSION);
+	serializer.serialize(static_cast<uint64_t>(table.getDataLength()));
+	serializer.serialize(table.getSerializedData(), table.getDataLength());
+	uint64_t tensorDataOffset = align(serializer.getDataLength());
+	size_t tensorIndex = 0;
+	for(const PolicyTensors& tensors : policyTensors) {
+		for(const std::pair<std::string, torch::Tensor>& tensor : tensors) {
+			// Padding. 
+			while(serializer.getDataLength() < tensorDataOffset + offsets[tensorIndex]) {
+				serializer.serialize(static_cast<int8_t>(0));
+			}
+			serializer.serialize(static_cast<const int8_t*>(tensor.second.data_ptr()), static_cast<uint64_t>(tensor.second.numel()) * tensor.second.element_size());
+			tensorIndex++;
+		}
+	}
+	serializer.finish();
+}
+
+bool MappedCheckpoint::isMappedCheckpoint(const std::string& filePath) {
+	std::ifstream stream;
+	stream.open(std::filesystem::u8path(filePath), std::ios::binary | std::ios::in);
+	int8_t data[4] = { 0, 0, 0, 0 };
+	stream.read(reinterpret_cast<char*>(data), 4);
+	if(stream.gcount() != 4) {
+		return false;
+	}
+	Deserializer deserializer = Deserializer(data, 4);
+	uint32_t magic = 0;
+	deserializer.deserialize(magic);
+	return magic == MAPPED_CHECKPOINT_MAGIC;
+}
+
+uint32_t MappedCheckpoint::getNumOfPolicies() const {
+	return static_cast<uint32_t>(policies.size());
+}
+
+torch::Tensor MappedCheckpoint::getTensor(uint32_t policyIndex, const std::string& name) const {
+	std::map<std::string, TensorEntry>::const_iterator it = policies[policyIndex].find(name);
+	if(it == policies[policyIndex].end()) {
+		return torch::Tensor();
+	}
+	const TensorEntry& entry = it->second;
+	torch::TensorOptions options = torch::TensorOptions().device(torch::kCPU).dtype(static_cast<torch::ScalarType>(entry.scalarType));
+	// The deleter keeps the mapping alive as long as the tensor exists. 
+	std::shared_ptr<MappedFile> mapping = file;
+	torch::Tensor tensor = torch::from_blob(file->getData() + dataOffset + entry.offset, entry.sizes, [mapping](void*) {}, options);
+	if(static_cast<uint64_t>(tensor.numel()) * tensor.element_size() != entry.size) {
+		throw io_error("Size of tensor \"" + name + "\" doesn't match its shape!");
+	}
+	return tensor;
+}
+
+// PRIVATE
+
+uint64_t MappedCheckpoint::align(uint64_t offset) {
+	return (offset + MAPPED_CHECKPOINT_ALIGNMENT - 1) / MAPPED_CHECKPOINT_ALIGNMENT * MAPPED_CHECKPOINT_ALIGNMENT;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+#include "CheckpointWriter.h"
+#include "TensorCheckpoint.h"
+#include "../util/MappedFile.h"
+
+namespace PLANS {
+
+	constexpr uint32_t MAPPED_CHECKPOINT_MAGIC = 0x544B4350;	// "PCKT". 
+	constexpr uint32_t MAPPED_CHECKPOINT_VERSION = 1;
+	constexpr uint64_t MAPPED_CHECKPOINT_ALIGNMENT = 64;
+
+	//############################ MappedCheckpoint ############################
+
+	/*
+	*	Uncompressed checkpoint, whose tensors are used directly from the memory mapped file. 
+	*		- Layout: header (magic, version, table size), tensor table, tensor data. Every tensor is aligned to MAPPED_CHECKPOINT_ALIGNMENT bytes. 
+	*		- The table lists name, type, sizes, offset and size of every tensor of every policy (names see TensorCheckpoint). 
+	*		- On the CPU, loaded tensors use the mapped pages directly (copy-on-write), so only the pages which are actually accessed are read. On CUDA, they are copied from the mapped pages to the device. 
+	*/
+	class MappedCheckpoint : public TensorCheckpoint {
+		public:
+			explicit MappedCheckpoint(const std::string& filePath);
+
+			// Writes the policies of the given snapshots (in this order). 
+			static void write(const std::string& filePath, const std::vector<PolicySnapshot*>& snapshots);
+			static void write(const std::string& filePath, const std::vector<PolicyTensors>& policyTensors);
+			static bool isMappedCheckpoint(const std::string& filePath);
+
+			uint32_t getNumOfPolicies() const override;
+			// The tensor uses the mapped pages. 
+			torch::Tensor getTensor(uint32_t policyIndex, const std::string& name) const override;
+		protected:
+		private:
+			struct TensorEntry {
+				int32_t scalarType;
+				std::vector<int64_t> sizes;
+				uint64_t offset;	// Relative to the start of the tensor data. 
+				uint64_t size;		// In bytes. 
+			};
+
+			std::shared_ptr<AEX::MappedFile> file;	// Shared with the loaded tensors, so the mapping lives as long as they do. 
+			uint64_t dataOffset;
+			std::vector<std::map<std::string, TensorEntry>> policies;
+
+			static uint64_t align(uint64_t offset);
+	};
+
+}
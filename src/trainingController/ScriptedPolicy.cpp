@@ -0,0 +1,70 @@
+#include "ScriptedPolicy.h"
+
+#include <filesystem>
+
+#include <torch/script.h>
+#include <torch/csrc/jit/frontend/tracer.h>
+
+using namespace PLANS;
+
+//############################ ScriptedPolicy ############################
+
+// PUBLIC
+
+ScriptedPolicy::ScriptedPolicy(const std::string& filePath, torch::Device device) : module(), device(device) {
+	module = torch::jit::load(filePath, device);
+	module.eval();
+}
+
+std::tuple<torch::Tensor, torch::Tensor> ScriptedPolicy::forward(const torch::Tensor& inputTensor) {
+	c10::InferenceMode inferenceMode;
+
+	std::vector<torch::jit::IValue> inputs = { inputTensor.device() == device ? inputTensor : inputTensor.to(device) };
+	c10::intrusive_ptr<c10::ivalue::Tuple> outputs = module.forward(inputs).toTuple();
+	return std::make_tuple(outputs->elements()[0].toTensor(), outputs->elements()[1].toTensor());
+}
+
+void ScriptedPolicy::write(const std::string& filePath, Model* model) {
+	// Parameters which require gradients can't be baked into the trace, so they are excluded from autograd until the module is written (the constants share the tensors). 
+	std::vector<torch::Tensor> parameters = model->get()->parameters();
+	std::vector<bool> requiresGrad = std::vector<bool>(parameters.size());
+	for(size_t i = 0; i < parameters.size(); i++) {
+		requiresGrad[i] = parameters[i].requires_grad();
+		parameters[i].requires_grad_(false);
+	}
+	std::function<void()> restoreRequiresGrad = [&parameters, &requiresGrad]() {
+		for(size_t i = 0; i < parameters.size(); i++) {
+			parameters[i].requires_grad_(requiresGrad[i]);
+		}
+	};
+
+	torch::jit::Module tracedModule = torch::jit::Module("PLANS.ScriptedPolicy");
+	tracedModule.register_attribute("training", c10::BoolType::get(), false);
+	try {
+		// Trace a single forward pass on an example input. The tensors of the model end up as constants of the graph. 
+		torch::Tensor exampleInput = torch::zeros({ 1, LSTM_INPUT_SIZE }, parameters.empty() ? TrainingController::getInstance()->getTensorOptions() : parameters[0].options());
+		std::function<torch::jit::Stack(torch::jit::Stack)> tracedFunction = [model](torch::jit::Stack inputs) -> torch::jit::Stack {
+			std::tuple<torch::Tensor, torch::Tensor> outputs = model->get()->forward(inputs[0].toTensor(), false);
+			return { c10::ivalue::Tuple::create({ std::get<0>(outputs), std::get<1>(outputs) }) };
+		};
+		std::function<std::string(const torch::autograd::Variable&)> nameLookup = [](const torch::autograd::Variable&) -> std::string { return ""; };
+		std::shared_ptr<torch::jit::Graph> graph = torch::jit::tracer::trace({ exampleInput }, tracedFunction, nameLookup, true, false, &tracedModule).first->graph;
+
+		torch::jit::Function* function = tracedModule._ivalue()->compilation_unit()->create_function(c10::QualifiedName(*tracedModule.type()->name(), "forward"), graph);
+		tracedModule.type()->addMethod(function);
+
+		// Freeze and optimize (folds e.g. constant subgraphs, fuses linear layers and activations where supported). 
+		tracedModule.eval();
+		torch::jit::Module frozenModule = torch::jit::freeze(tracedModule);
+		frozenModule = torch::jit::optimize_for_inference(frozenModule);
+
+		// Write to a temporary file first, then replace the final file at once. 
+		std::string tmpFilePath = filePath + ".tmp";
+		frozenModule.save(tmpFilePath);
+		std::filesystem::rename(std::filesystem::u8path(tmpFilePath), std::filesystem::u8path(filePath));
+	} catch(...) {
+		restoreRequiresGrad();
+		throw;
+	}
+	restoreRequiresGrad();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <tuple>
+
+#include <torch/csrc/jit/api/module.h>
+
+#include "TrainingController.h"
+
+namespace PLANS {
+
+	//############################ ScriptedPolicy ############################
+
+	/*
+	*	Policy exported as frozen TorchScript module, for evaluation runs and deployment. 
+	*		- "write" traces the forward pass of a model, freezes the traced module (parameters become constants) and runs the inference graph optimizations on it. 
+	*		- The traced forward pass is the one of the model, so the module returns the sampled action and the value like the model does. 
+	*		- The exported module is evaluated under torch::InferenceMode, so neither autograd bookkeeping nor the eager dispatch of the single layers is paid. 
+	*/
+	class ScriptedPolicy {
+		public:
+			// Loads an exported policy onto the given device, which has to be the one it has been exported on (see write). Throws, if the file isn't a valid TorchScript module. 
+			ScriptedPolicy(const std::string& filePath, torch::Device device);
+
+			// Inputs on another device are copied to the device of the policy. The outputs stay on the device of the policy. 
+			// Returned tuple: [0]: Actor output of size { batch size, LSTM_OUTPUT_SIZE }, [1]: Critic output of size { batch size, 1 }. 
+			std::tuple<torch::Tensor, torch::Tensor> forward(const torch::Tensor& inputTensor);
+
+			// Traces the model on the device it's on, so the exported policy runs on that device. The file is replaced at once. Throws, if the model can't be traced. 
+			static void write(const std::string& filePath, Model* model);
+		protected:
+		private:
+			torch::jit::Module module;
+			torch::Device device;
+	};
+
+}
@@ -0,0 +1,63 @@
+#include "TensorCheckpoint.h"
+
+#include <cstring>
+
+#include "../util/IOUtils.h"
+
+using namespace PLANS;
+using namespace AEX;
+
+//############################ TensorCheckpoint ############################
+
+// PUBLIC
+
+TensorCheckpoint::~TensorCheckpoint() {}
+
+void TensorCheckpoint::loadModel(uint32_t policyIndex, Model* model) const {
+	torch::NoGradGuard noGrad;
+	for(auto& item : model->get()->named_parameters()) {
+		loadTensor(policyIndex, "model." + item.key(), item.value());
+	}
+	for(auto& item : model->get()->named_buffers()) {
+		loadTensor(policyIndex, "model." + item.key(), item.value());
+	}
+}
+
+void TensorCheckpoint::loadOptimizer(uint32_t policyIndex, Optimizer* optimizer) const {
+	torch::Tensor state = getTensor(policyIndex, "optimizer");
+	if(!state.defined()) {
+		return;	// No optimizer state (e.g. checkpoints of older versions). 
+	}
+	// The archive maps the state onto the parameters of the optimizer by their order. 
+	torch::load(*optimizer, static_cast<const char*>(state.data_ptr()), static_cast<size_t>(state.numel()));
+}
+
+void TensorCheckpoint::collectTensors(Model* model, const std::vector<int8_t>& optimizerState, PolicyTensors& tensors) {
+	torch::NoGradGuard noGrad;
+	for(const auto& item : model->get()->named_parameters()) {
+		tensors.emplace_back("model." + item.key(), item.value().detach().to(torch::kCPU).contiguous());
+	}
+	for(const auto& item : model->get()->named_buffers()) {
+		tensors.emplace_back("model." + item.key(), item.value().detach().to(torch::kCPU).contiguous());
+	}
+	torch::Tensor state = torch::empty({ static_cast<int64_t>(optimizerState.size()) }, torch::TensorOptions().dtype(torch::kInt8));
+	std::memcpy(state.data_ptr(), optimizerState.data(), optimizerState.size());
+	tensors.emplace_back("optimizer", state);
+}
+
+// PRIVATE
+
+void TensorCheckpoint::loadTensor(uint32_t policyIndex, const std::string& name, torch::Tensor& target) const {
+	torch::Tensor source = getTensor(policyIndex, name);
+	if(!source.defined()) {
+		throw io_error("Tensor \"" + name + "\" is missing in the checkpoint!");
+	}
+	if(source.sizes() != target.sizes() || source.scalar_type() != target.scalar_type()) {
+		throw io_error("Tensor \"" + name + "\" doesn't match the model!");
+	}
+	if(target.device().is_cpu()) {
+		target.set_data(source);
+	} else {
+		target.copy_(source);
+	}
+}
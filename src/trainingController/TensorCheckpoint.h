@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "TrainingController.h"
+
+namespace PLANS {
+
+	// Named tensors of a policy, see TensorCheckpoint::collectTensors. 
+	using PolicyTensors = std::vector<std::pair<std::string, torch::Tensor>>;
+
+	//############################ TensorCheckpoint ############################
+
+	/*
+	*	Checkpoint, which provides the tensors of its policies by name. 
+	*		- Model tensors are named "model.<name>". The optimizer state is stored as int8 tensor "optimizer", which contains the archive written by torch::save (see PolicySnapshot). 
+	*		- Provided tensors are CPU tensors. They may be used by the loaded model directly, so they must not be modified by the checkpoint afterwards. 
+	*/
+	class TensorCheckpoint {
+		public:
+			virtual ~TensorCheckpoint();
+
+			virtual uint32_t getNumOfPolicies() const = 0;
+			// Returns an undefined tensor, if the policy doesn't contain a tensor of the given name. 
+			virtual torch::Tensor getTensor(uint32_t policyIndex, const std::string& name) const = 0;
+
+			// Lets the parameters and buffers of the model use the tensors of the given policy (CPU) or copies them (CUDA). 
+			void loadModel(uint32_t policyIndex, Model* model) const;
+			// Restores the optimizer state of the given policy. Leaves the optimizer as is, if the checkpoint doesn't contain one. 
+			void loadOptimizer(uint32_t policyIndex, Optimizer* optimizer) const;
+
+			// Collects the named tensors of model and optimizer state (see PolicySnapshot) as contiguous CPU tensors. 
+			static void collectTensors(Model* model, const std::vector<int8_t>& optimizerState, PolicyTensors& tensors);
+		protected:
+		private:
+			void loadTensor(uint32_t policyIndex, const std::string& name, torch::Tensor& target) const;
+	};
+
+}
@@ -7,11 +7,19 @@
 #include "../TrainingParameters.h"
 #include "../TrainingRewarder.h"
 #include "../TrainingEncoder.h"
+#include "../StateArena.h"
+#include "../TrainingGAE.h"
+#include "../MiniBatchSampler.h"
+#include "CheckpointWriter.h"
+#include "MappedCheckpoint.h"
+#include "DeltaCheckpoint.h"
 #include "../TrainingLogger.h"
 #include "../Environment.h"
+#include "../FastActorCritic.h"
 #include "../util/Maths.h"
 #include "../util/StringUtils.h"
 #include "../util/IOUtils.h"
+#include "../util/compression/GZip.h"
 #include "../util/HTTPHelper.h"
 
 using namespace PLANS;
@@ -19,10 +27,22 @@ using namespace AEX;
 
 //############################ Agent ############################
 
-Agent::Agent(AGENT_ID agentID) : agentID(agentID), model(nullptr), states(), actions(), logProbs(), values(), rewards(), totalReward(0.0), rewardsCount(0) {
+Agent::Agent(AGENT_ID agentID, Agent* policyAgent) : agentID(agentID), model(nullptr), actorModel(nullptr), optimizer(nullptr), fastActor(nullptr), ownsPolicy(policyAgent == nullptr), deferredCheckpoint(nullptr), deferredPolicyIndex(0), rollout(nullptr), trainingRollout(nullptr), episodeStartIndex(0), episodeReward(0.0), episodeSteps(0) {
 	
-	// Reserve memory for rewards. 
-	rewards.reserve(TrainingController::getInstance()->getTrainingParameters()->trainingStepLength);
+	// Create rollout buffers, sized for the steps between two optimizations. Rollouts exceeding the capped capacity double it, which is kept across clears. 
+	const TrainingParameters* params = TrainingController::getInstance()->getTrainingParameters();
+	uint32_t rolloutCapacity = Maths::max<uint32_t>(Maths::min<uint32_t>(TrainingController::getInstance()->getRolloutCapacity(), TrainingController::MAX_INITIAL_ROLLOUT_CAPACITY), 1);
+	rollout = new RolloutBuffer(rolloutCapacity);
+	trainingRollout = new RolloutBuffer(rolloutCapacity);
+
+	if(!ownsPolicy) {
+		// Share the policy of the given agent. 
+		model = policyAgent->model;
+		actorModel = policyAgent->actorModel;
+		optimizer = policyAgent->optimizer;
+		fastActor = policyAgent->fastActor;
+		return;
+	}
 
 	// Create model. 
 	model = new Model(STD);
@@ -35,14 +55,40 @@ Agent::Agent(AGENT_ID agentID) : agentID(agentID), model(nullptr), states(), act
 #else
 	model->get()->toDevice(torch::kCPU);
 #endif
+
+	if(TrainingController::getInstance()->getTrainingParameters()->asyncLearner) {
+		// The actors need an own copy of the model, as the learner thread updates "model" while they collect rollouts. The weights are copied via "TrainingController::publishPolicy". 
+		actorModel = new Model(STD);
+#ifdef USE_CUDA
+		actorModel->get()->toDevice(torch::kCUDA);
+#else
+		actorModel->get()->toDevice(torch::kCPU);
+#endif
+	} else {
+		actorModel = model;
+	}
+#ifndef USE_CUDA
+	// The actors run on the CPU, so they can skip torch. The snapshot is taken once the weights are final (see TrainingController::publishPolicy). 
+	if(params->fastInference) {
+		fastActor = new FastActorCritic();
+	}
+#endif
 	
 	// Create optimizer. 
 	optimizer = new Optimizer(model->get()->parameters(), torch::optim::AdamOptions(TrainingController::getInstance()->getTrainingParameters()->learningRate));
 }
 
 Agent::~Agent() {
-	delete model;
-	delete optimizer;
+	delete rollout;
+	delete trainingRollout;
+	if(ownsPolicy) {
+		if(actorModel != model) {
+			delete actorModel;
+		}
+		delete fastActor;
+		delete model;
+		delete optimizer;
+	}
 }
 
 //############################ StateData ############################
@@ -77,6 +123,7 @@ bool TrainingController::init() {
 	}
 	//
 	ensureRequiredDirectories();
+	checkpointWriter = new CheckpointWriter(params);
 	// Init tensor options. 
 #ifdef USE_CUDA
 	tensorOptions = tensorOptions.device(torch::kCUDA).dtype(torch::kFloat32).requires_grad(false);
@@ -89,6 +136,16 @@ bool TrainingController::init() {
 }
 
 void TrainingController::cleanUp() {
+	// Finish pending checkpoints, before anything they might refer to is torn down. 
+	if(checkpointWriter != nullptr) {
+		checkpointWriter->flush();
+	}
+	// The learner thread accesses the parameters and agents. 
+	stopLearner();
+	if(checkpointWriter != nullptr) {
+		delete checkpointWriter;
+		checkpointWriter = nullptr;
+	}
 	// Clean up parameters. 
 	if(params != nullptr) {
 		delete params;
@@ -96,6 +153,11 @@ void TrainingController::cleanUp() {
 	}
 	//
 	cleanUpInternal();
+	// The state datas are cleaned up by now. 
+	if(stateArena != nullptr) {
+		delete stateArena;
+		stateArena = nullptr;
+	}
 }
 
 void TrainingController::consoleOut(const std::string& output, bool regardVerbosity) const {
@@ -125,6 +187,18 @@ bool TrainingController::isVerbose() const {
 	return verbose;
 }
 
+void TrainingController::onActionsRequired(std::vector<std::vector<torch::Tensor>>& outputs) {
+	for(AGENT_ID agentID : agentIDs) {
+		onActionRequired(agentID, outputs[agentID]);
+	}
+}
+
+void TrainingController::onAgentsExecuted(const std::vector<AGENT_ID>& agentIDs) {
+	for(AGENT_ID agentID : agentIDs) {
+		onAgentExecuted(agentID);
+	}
+}
+
 uint32_t TrainingController::getTrainedEpisodes() const {
 	return trainedEpisodes;
 }
@@ -135,7 +209,7 @@ uint32_t TrainingController::getStepsInThisEpisode() const {
 
 // PROTECTED
 
-TrainingController::TrainingController(TrainingParameters* parameters, Environment* enviroment) : params(parameters), enviroment(enviroment), tensorOptions(), tensorOptionsCPU(), verbose(false), trainedEpisodes(0), stepsInThisEpisode(0), backwardMutex(), agents(), stateDatas(), stateDataMutex() {
+TrainingController::TrainingController(TrainingParameters* parameters, Environment* enviroment) : params(parameters), enviroment(enviroment), tensorOptions(), tensorOptionsCPU(), verbose(false), trainedEpisodes(0), stepsInThisEpisode(0), backwardMutex(), agents(), agentIDs(), stateDatas(nullptr), builtStateDataSlot(NO_STATE_DATA_SLOT), stateArena(nullptr), learnerThread(), learnerMutex(), learnerCondition(), learnerAgents(), learnerStopping(false), policiesOutdated(false), checkpointWriter(nullptr) {
 	instance = this;
 }
 
@@ -156,10 +230,16 @@ void TrainingController::initAgents(uint32_t numOfAgents) {
 		consoleOut("TrainingController::initAgents: Agents already initialized.");
 		return;
 	}
-	// Create agents. 
+	// Create agents. If multiple environment instances are used, all agents share the policy of the first one. 
 	for(uint32_t i = 0; i < numOfAgents; i++) {
-		agents.push_back(new Agent(i));
+		if(i > 0 && params->numOfEnvironments > 1) {
+			agents.push_back(new Agent(i, agents[0]));
+		} else {
+			agents.push_back(new Agent(i));
+		}
+		agentIDs.push_back(i);
 	}
+	stateArena = new StateArena(numOfAgents);
 	// Load agents. 
 	uint32_t loadedEpisode = loadAgents();
 	// Check for loading failure. 
@@ -170,67 +250,51 @@ void TrainingController::initAgents(uint32_t numOfAgents) {
 		TrainingLogger::logFile("#### Loaded checkpoint, starting at episode " + std::to_string(loadedEpisode) + ". ####");
 	}
 	trainedEpisodes = loadedEpisode;
+	// Hand the (loaded) weights to the actors. 
+	for(Agent* agent : agents) {
+		if(agent->ownsPolicy) {
+			publishPolicy(agent);
+		}
+	}
+	// Start learner thread. 
+	if(params->asyncLearner) {
+		learnerThread = std::thread(&TrainingController::learnerLoop, this);
+	}
 }
 
 std::vector<Agent*>& TrainingController::getAgents() {
 	return agents;
 }
 
-void TrainingController::addStateData(AGENT_ID agentID, const StateData* stateData) {
-	stateDataMutex.lock();
-	std::vector<StateData*>& list = stateDatas[agentID];
-#ifdef _DEBUG
-	const StateData* tmp = getStateData(agentID, stateData->stepIndex);
-	if(tmp != nullptr) {
-		consoleOut("TrainingController::addStateData: LinkedList already contains a state data with step index \"" + std::to_string(stateData->stepIndex) + "\"");
-		stateDataMutex.unlock();
-		return;
-	}
-#endif
-	list.push_back(const_cast<StateData*>(stateData));
-	stateDataMutex.unlock();
+const std::vector<AGENT_ID>& TrainingController::getAgentIDs() const {
+	return agentIDs;
 }
 
 const StateData* TrainingController::getStateData(AGENT_ID agentID, uint32_t stepIndex) {
-	std::vector<StateData*>& list = stateDatas[agentID];
-	for(const StateData* stateData : list) {
-		if(stateData->stepIndex == stepIndex) {
-			return stateData;
-		}
+	// Only the state datas of the current step are kept. 
+	if(stateDatas == nullptr || builtStateDataSlot != stepIndex + 1) {
+		return nullptr;
 	}
-	return nullptr;
-}
-
-std::vector<std::vector<StateData*>>& TrainingController::getStateDatas() {
-	return stateDatas;
+	return stateDatas[agentID];
 }
 
 const StateData* TrainingController::getOrCreateStateData(AGENT_ID agentID) {
-	// Get or create state data. 
-	stateDataMutex.lock();
-	const StateData* stateData = getStateData(agentID, getStepsInThisEpisode());
-	if(stateData != nullptr) {
-		stateDataMutex.unlock();
-		return stateData;
-	} else {
-		// Build state data via encoder. 
-		stateData = TrainingEncoder::buildInputTensor(agentID, getEnvironment());
-		// Save state data, as it's new. 
-		stateDataMutex.unlock();
-		addStateData(agentID, stateData);
-		return stateData;
+	uint32_t slot = getStepsInThisEpisode() + 1;
+	// The first call of a step builds the state datas of all agents at once via encoder (one observation batch per step). 
+	if(builtStateDataSlot != slot) {
+		stateDatas = stateArena->buildStep(getEnvironment(), getStepsInThisEpisode());
+		builtStateDataSlot = slot;
 	}
+	return stateDatas[agentID];
 }
 
 void TrainingController::cleanUpStateDatas() {
-	stateDataMutex.lock();
-	for(std::vector<StateData*>& list : stateDatas) {
-		for(StateData* stateData : list) {
-			delete stateData;
-		}
-		list.clear();
+	// The state datas belong to the arena. 
+	stateDatas = nullptr;
+	builtStateDataSlot = NO_STATE_DATA_SLOT;
+	if(stateArena != nullptr) {
+		stateArena->reset();
 	}
-	stateDataMutex.unlock();
 }
 
 void TrainingController::ensureRequiredDirectories() const {
@@ -239,26 +303,6 @@ void TrainingController::ensureRequiredDirectories() const {
 	}
 }
 
-void TrainingController::serializeAgent(Agent* agent, const std::string& tmpFilePath, Serializer& serializer) {
-	// Write each thing to a temporary file and load them (there was no better solution to get the byte data). 
-	int8_t* data;
-	uint64_t dataSize = 0;
-
-	torch::save(*agent->model, tmpFilePath);
-	// Read from temporary file. 
-	data = IOUtils::readBytesFromFile(tmpFilePath, dataSize);
-	serializer.serialize(dataSize);
-	serializer.serialize(data, dataSize);
-	delete[] data;
-
-	torch::save(*agent->optimizer, tmpFilePath);
-	// Read from temporary file. 
-	data = IOUtils::readBytesFromFile(tmpFilePath, dataSize);
-	serializer.serialize(dataSize);
-	serializer.serialize(data, dataSize);
-	delete[] data;
-}
-
 void TrainingController::saveAgents(uint32_t episode, std::string& checkpointFilePath) {
 	// Determine checkpoint file path. 
 	std::string checkpointFileName = TrainingController::params->modelNameLoad + CHECKPOINT_FILE_EXTENSION;
@@ -267,221 +311,403 @@ void TrainingController::saveAgents(uint32_t episode, std::string& checkpointFil
 	}
 	checkpointFilePath = "./" + TrainingController::params->checkpointDirectoryName + "/" + checkpointFileName;
 
-	// Prepare stuff. 
-	Serializer serializer = Serializer();
-	std::string tmpFilePath = "./" + TrainingController::params->checkpointDirectoryName + "/tmp.pt";
-
-	// Serialize agents. 
+	// Take snapshots of the agents. Shared policies are only saved once. 
+	// An asynchronous learner may be optimizing right now, so the published policies are saved instead (see publishPolicy). They are only modified by this thread. 
+	if(!params->asyncLearner) {
+		loadDeferredOptimizerStates();
+	}
+	std::vector<PolicySnapshot*> snapshots;
 	for(Agent* agent : agents) {
-		serializeAgent(agent, tmpFilePath, serializer);
+		if(!agent->ownsPolicy) {
+			continue;
+		}
+		if(agent->actorModel != agent->model) {
+			snapshots.push_back(new PolicySnapshot(agent->actorModel, agent->publishedOptimizerState));
+		} else {
+			snapshots.push_back(new PolicySnapshot(agent->model, agent->optimizer));
+		}
 	}
 
-	// Delete temporary file. 
-	IOUtils::remove(tmpFilePath);
-
-	// Write compressed bytes to final checkpoint file. 
-	IOUtils::writeCompressedBytesToFile(checkpointFilePath, true, serializer.getSerializedData(), serializer.getDataLength());
+	// Serialization, compression and writing happen on the writer thread. 
+	checkpointWriter->write(checkpointFilePath, episode, snapshots);
 }
 
-void TrainingController::deserializeAgent(Agent* agent, const std::string& tmpFilePath, Deserializer& deserializer) {
-	// Write each piece to temporary file and load it via "torch::load". 
+void TrainingController::deserializeAgent(Agent* agent, Deserializer& deserializer) {
+	// Load each piece via "torch::load" directly from the data of the deserializer (no copy). 
 	uint64_t dataSizePiece = 0;
 	int8_t* pieceData = 0;
 
 	deserializer.deserialize(dataSizePiece);
 	deserializer.deserialize(pieceData, dataSizePiece);
-	IOUtils::writeBytesToFile(tmpFilePath, true, pieceData, dataSizePiece);
-	torch::load(*agent->model, tmpFilePath);
+	torch::load(*agent->model, reinterpret_cast<const char*>(pieceData), static_cast<size_t>(dataSizePiece));
 
 	deserializer.deserialize(dataSizePiece);
 	deserializer.deserialize(pieceData, dataSizePiece);
-	IOUtils::writeBytesToFile(tmpFilePath, true, pieceData, dataSizePiece);
-	torch::load(*agent->optimizer, tmpFilePath);
+	torch::load(*agent->optimizer, reinterpret_cast<const char*>(pieceData), static_cast<size_t>(dataSizePiece));
 }
 
 uint32_t TrainingController::loadAgents() {
-	// Determine checkpoint file path. 
+	// Determine checkpoint file path. The checkpoint index knows the latest checkpoint, no need to scan the directory. 
 	uint32_t highestEpisode = UINT32_MAX;
-	std::string checkpointFilename;
-	// Search checkpoints for valid files. 
-	DirectoryIterator directoryIterator = IOUtils::getDirectoryIterator("./" + TrainingController::params->checkpointDirectoryName + "/");
-	uint32_t splitCount;
-	std::string* splitParts = new std::string[2];
-	std::string tmpString;
-	uint32_t currentEpisode;
-	for(const DirectoryEntry entry : directoryIterator) {
-		if(entry.isDirectory) {
-			continue;	// Ignore directories. 
-		}
-		if(entry.extension != CHECKPOINT_FILE_EXTENSION) {
-			continue;	// Wrong file extension. 
-		}
-		splitCount = StringUtils::split(entry.name, "_", splitParts, 2);
-		// Check for correct model name. 
-		if(splitCount == 1) {
-			tmpString = splitParts[0];
-			StringUtils::replace(tmpString, CHECKPOINT_FILE_EXTENSION, "");
-			if(tmpString != TrainingController::params->modelNameLoad) {
-				continue;	// Wrong model name. 
-			}
-		} else if(splitCount == 2 && splitParts[0] != TrainingController::params->modelNameLoad) {
-			continue;	// Wrong model name. 
-		}
-		// Check for episode in file name. 
-		if(StringUtils::startsWith(splitParts[1], "episode") && StringUtils::endsWith(splitParts[1], CHECKPOINT_FILE_EXTENSION)) {
-			// There is an episode encoded. Parse it. 
-			tmpString = splitParts[1];
-			StringUtils::replace(tmpString, "episode", "");
-			StringUtils::replace(tmpString, CHECKPOINT_FILE_EXTENSION, "");
-			try {
-				currentEpisode = static_cast<uint32_t>(std::stoi(tmpString));
-			} catch(std::exception&) {
-				// Not just a number, also letters. Can't parse the episode. Ignore this checkpoint file. 
-				continue;
-			}
-		} else {
-			// There is no episode encoded. Assume episode 0 then. 
-			currentEpisode = 0;
-		}
-		// Check if the current episode is greater. 
-		if(highestEpisode == UINT32_MAX || currentEpisode > highestEpisode) {
-			highestEpisode = currentEpisode;
-			checkpointFilename = entry.name;
-		}
-	}
-	delete[] splitParts;
-	// 
-	if(highestEpisode == UINT32_MAX) {
+	std::string checkpointFilePath;
+	if(!checkpointWriter->getLatestCheckpoint(checkpointFilePath, highestEpisode)) {
 		consoleOut("TrainingController::loadAgents: No checkpoint file found.", false);
 		return UINT32_MAX;
 	}
-	std::string checkpointFilePath = "./" + TrainingController::params->checkpointDirectoryName + "/" + checkpointFilename;
-
-	std::string tmpFilePath = "./" + TrainingController::params->checkpointDirectoryName + "/tmp.pt";
 
-	// Load compressed bytes. 
-	uint64_t dataSizeTotal = 0;
-	int8_t* data = IOUtils::readCompressedBytesFromFile(checkpointFilePath, dataSizeTotal);
+	// Mapped checkpoints are used directly, delta checkpoints are reconstructed from their base. 
+	// The optimizer states are only loaded once they are needed, which never happens if no agent is optimized. 
+	std::shared_ptr<TensorCheckpoint> checkpoint = nullptr;
+	if(MappedCheckpoint::isMappedCheckpoint(checkpointFilePath)) {
+		checkpoint = std::make_shared<MappedCheckpoint>(checkpointFilePath);
+	} else if(!DeltaCheckpointFormat::getBaseFileName(checkpointFilePath).empty()) {
+		checkpoint = std::make_shared<DeltaCheckpoint>(checkpointFilePath, params->checkpointCompressionThreads);
+	}
+	if(checkpoint != nullptr) {
+		uint32_t policyIndex = 0;
+		for(Agent* agent : agents) {
+			if(agent->ownsPolicy) {
+				if(policyIndex >= checkpoint->getNumOfPolicies()) {
+					consoleOut("TrainingController::loadAgents: Checkpoint contains fewer policies than agents.", false);
+					abort();
+				}
+				checkpoint->loadModel(policyIndex, agent->model);
+				agent->deferredCheckpoint = checkpoint;
+				agent->deferredPolicyIndex = policyIndex;
+				policyIndex++;
+			}
+		}
+		return highestEpisode;
+	}
 
-	// Create deserializer. 
-	Deserializer deserializer = Deserializer(data, dataSizeTotal, 0, true);
+	// Create deserializer. Block compressed checkpoints are loaded at once and decompressed in parallel. 
+	// Gzip compressed checkpoints (streamed or older ones) are decompressed while deserializing. 
+	FileInputSource* fileSource = nullptr;
+	GZipInputSource* gzipSource = nullptr;
+	Deserializer deserializer = Deserializer();
+	if(IOUtils::isBlockCompressedFile(checkpointFilePath)) {
+		uint64_t dataSizeTotal = 0;
+		int8_t* data = IOUtils::readBlockCompressedBytesFromFile(checkpointFilePath, dataSizeTotal, params->checkpointCompressionThreads);
+		deserializer = Deserializer(data, dataSizeTotal, 0, true);
+	} else {
+		fileSource = new FileInputSource(checkpointFilePath);
+		gzipSource = new GZipInputSource(fileSource);
+		deserializer = Deserializer(gzipSource);
+	}
 
-	// Deserialize agents. 
+	// Deserialize agents. Shared policies are only loaded once. 
 	for(Agent* agent : agents) {
-		deserializeAgent(agent, tmpFilePath, deserializer);
+		if(agent->ownsPolicy) {
+			deserializeAgent(agent, deserializer);
+		}
 	}
 
-	// Delete temporary file. 
-	IOUtils::remove(tmpFilePath);
+	delete gzipSource;
+	delete fileSource;
 
 	return highestEpisode;
 }
 
-void TrainingController::optimizePPO(Agent* agent) {
+void TrainingController::loadDeferredOptimizerStates() {
+	for(Agent* agent : agents) {
+		if(agent->deferredCheckpoint != nullptr) {
+			agent->deferredCheckpoint->loadOptimizer(agent->deferredPolicyIndex, agent->optimizer);
+			agent->deferredCheckpoint = nullptr;	// The loaded tensors keep the mapping alive on their own. 
+		}
+	}
+}
+
+void TrainingController::runPolicies(const std::vector<AGENT_ID>& agentIDs, std::vector<std::vector<torch::Tensor>>& outputs) {
+	// Use the newest weights, if the learner thread finished an optimization. 
+	publishOutdatedPolicies();
 
-	consoleOut("TrainingController::optimizePPO: Agent " + std::to_string(agent->agentID) + ", total reward: " + std::to_string(agent->totalReward), false);
+	std::vector<bool> processed = std::vector<bool>(agentIDs.size(), false);
+	std::vector<size_t> batchIndices;
+	std::vector<torch::Tensor> batchStates;
+	std::vector<torch::Tensor> batchInputs;
+	for(size_t i = 0; i < agentIDs.size(); i++) {
+		if(processed[i]) {
+			continue;	// Already evaluated together with an agent sharing its policy. 
+		}
 
-	torch::Tensor t_values = torch::cat(agent->values).detach().to(torch::kCPU);
+		// Gather the inputs of all agents sharing the policy of this agent. 
+		Model* model = agents[agentIDs[i]]->actorModel;
+		batchIndices.clear();
+		batchStates.clear();
+		batchInputs.clear();
+		for(size_t j = i; j < agentIDs.size(); j++) {
+			Agent* agent = agents[agentIDs[j]];
+			if(processed[j] || agent->actorModel != model) {
+				continue;
+			}
+			// Get or create state data. 
+			const StateData* stateData = getOrCreateStateData(agentIDs[j]);
+			batchIndices.push_back(j);
+			batchStates.push_back(stateData->inputTensor);
+			batchInputs.push_back(stateData->inputTensorDevice);
+			processed[j] = true;
+		}
 
-	// Calculate the returns. 
-	torch::Tensor gae = torch::zeros(1, getTensorOptionsCPU());
-	std::vector<torch::Tensor> returns = std::vector<torch::Tensor>(agent->rewards.size(), torch::zeros(1, getTensorOptionsCPU()));
-	torch::Tensor delta;
-	for(size_t i = agent->rewards.size() - 1; i > 0; i--) {
-		delta = agent->rewards[i] + getTrainingParameters()->ppo_gamma * t_values[i - 1] - t_values[i];	// See [SchulmanEtAl, 2017]_PPO, Equation (12)
-		gae = delta + getTrainingParameters()->ppo_gamma * getTrainingParameters()->ppo_lambda * gae;
+#if defined(_DEBUG) and defined(MEASURE_TIME)
+		auto start = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
+#endif
 
-		returns[i] = gae + t_values[i];
-	}
+		// Evaluate the policy. Produces rows of { actor output, logProb, value } on the CPU. 
+		int64_t actionSize = LSTM_OUTPUT_SIZE;
+		torch::Tensor packedOutputs;
+		FastActorCritic* fastActor = agents[agentIDs[i]]->fastActor;
+		if(fastActor != nullptr && fastActor->isValid()) {
+			// Evaluate the inputs one by one without torch (see FastActorCritic). 
+			packedOutputs = torch::empty({ static_cast<int64_t>(batchIndices.size()), actionSize * 2 + 1 }, tensorOptionsCPU);
+			float* packedData = packedOutputs.data_ptr<float>();
+			for(size_t b = 0; b < batchIndices.size(); b++) {
+				float* row = packedData + b * (actionSize * 2 + 1);
+				fastActor->act(batchStates[b].data_ptr<float>(), row, row + actionSize, row[actionSize * 2]);
+			}
+		} else {
+			// Only the raw outputs are kept (see RolloutBuffer), the gradients are computed by the forward pass in "optimizePPO". So no graph is recorded and no version counters are tracked. 
+			c10::InferenceMode inferenceMode;
 
-	// Build copies of tensors. 
-	torch::Tensor t_logProbs = torch::cat(agent->logProbs).detach().to(torch::kCPU);
-	torch::Tensor t_returns = torch::cat(returns).detach();
-	torch::Tensor t_states = torch::cat(agent->states).to(torch::kCPU);
-	torch::Tensor t_actions = torch::cat(agent->actions).to(torch::kCPU);
+			// Pass inputs into model to produce actor and critic outputs, both of size { batch size, 1 }. 
+			torch::Tensor inputs = batchInputs.size() == 1 ? batchInputs[0] : torch::cat(batchInputs);
+			std::tuple<torch::Tensor, torch::Tensor> outputTuple = model->get()->forward(inputs, true);
+			torch::Tensor actorOutputs = std::get<0>(outputTuple);
+			torch::Tensor criticOutputs = std::get<1>(outputTuple);
 
-	// Calculate the advantages. 
-	torch::Tensor t_advantages = (t_returns - t_values).slice(0, 0, getTrainingParameters()->trainingStepLength);	// Size: { trainingStepLength(120) }
+			// Create logProbs (based on the distribution of the forward pass above). 
+			torch::Tensor logProbs = model->get()->logProb(actorOutputs);
 
-	//int64_t a_a = t_advantages.dim();
-	//int64_t a_b = t_advantages.size(0);
+			// Pack actor outputs, logProbs and critic outputs, so they are copied to the CPU at once. 
+			actionSize = actorOutputs.size(1);
+			packedOutputs = torch::cat({ actorOutputs, logProbs, criticOutputs }, 1);
+#ifdef USE_CUDA
+			if(packedOutputs.is_cuda()) {
+				// Copy asynchronously into pinned memory (cached by the allocator) and synchronize only once per batch. 
+				torch::Tensor packedOutputsHost = torch::empty(packedOutputs.sizes(), tensorOptionsCPU.pinned_memory(true));
+				packedOutputsHost.copy_(packedOutputs, true);
+				torch::cuda::synchronize();
+				packedOutputs = packedOutputsHost;
+			}
+#endif
+		}
+		int64_t packedSize = actionSize * 2 + 1;
+		const float* outputsData = packedOutputs.data_ptr<float>();
 
-	// NOTE: From here the sources are https://github.com/mhubii/ppo_libtorch/tree/master and https://github.com/ericyangyu/PPO-for-Beginners. 
-	torch::Tensor mini_states;
-	torch::Tensor mini_actions;
-	torch::Tensor mini_logProbs;
-	torch::Tensor mini_returns;
-	torch::Tensor mini_advantages;
-	for(uint32_t i = 0; i < getTrainingParameters()->ppo_epochs; i++) {
-		// Construct mini batch. 
-		mini_states = torch::zeros({ getTrainingParameters()->ppo_miniBatchSize, LSTM_INPUT_SIZE }, getTensorOptions());
-		mini_actions = torch::zeros({ getTrainingParameters()->ppo_miniBatchSize, LSTM_OUTPUT_SIZE }, getTensorOptions());
-		mini_logProbs = torch::zeros({ getTrainingParameters()->ppo_miniBatchSize, LSTM_OUTPUT_SIZE }, getTensorOptions());
-		mini_returns = torch::zeros({ getTrainingParameters()->ppo_miniBatchSize, 1 }, getTensorOptions());
-		mini_advantages = torch::zeros({ getTrainingParameters()->ppo_miniBatchSize, 1 }, getTensorOptions());
-
-		uint32_t idx;
-		for(uint32_t b = 0; b < getTrainingParameters()->ppo_miniBatchSize; b++) {
-			//idx = std::uniform_int_distribution<uint32_t>(0, getTrainingParameters()->trainingStepLength - 1)(re);	// Randomize order. 
-			idx = (i * getTrainingParameters()->ppo_miniBatchSize) + b;
-			mini_states[b] = t_states[idx];
-			mini_actions[b] = t_actions[idx];
-			mini_logProbs[b] = t_logProbs[idx];
-			mini_returns[b] = t_returns[idx];
-			mini_advantages[b] = t_advantages[idx];
+#if defined(_DEBUG) and defined(MEASURE_TIME)
+		auto finish = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
+		auto total = finish - start;
+		std::cout << "[batch of " + std::to_string(batchIndices.size()) + "] ran from " + std::to_string(start) + " to " + std::to_string(finish) + "(total of " + std::to_string(total) + ")" << std::endl;
+#endif
+
+		// Scatter outputs to the agents. 
+		for(size_t b = 0; b < batchIndices.size(); b++) {
+			Agent* agent = agents[agentIDs[batchIndices[b]]];
+			const float* row = outputsData + b * packedSize;
+			// Save state, action (just the action type at index 0), logProb and value returned by the critic. 
+			agent->rollout->addStep(batchStates[b].data_ptr<float>(), row[0], row + actionSize, row[actionSize * 2]);
+			// Fill output vector with views on the CPU rows. 
+			torch::Tensor packedRow = packedOutputs[b];
+			outputs[batchIndices[b]].push_back(packedRow.narrow(0, 0, actionSize));
+			outputs[batchIndices[b]].push_back(packedRow.narrow(0, actionSize * 2, 1));
 		}
+	}
+}
 
-		//mini_states.dim();
-		//mini_states.size(0); // trainingStepLength
-		//mini_states.size(1); // TrainingControllerContinuous::LSTM_INPUT_SIZE
+void TrainingController::optimizeAgents(const std::vector<Agent*>& agentsToOptimize) {
+	if(!params->asyncLearner) {
+		optimizePolicies(agentsToOptimize, false);
+		for(Agent* agent : agentsToOptimize) {
+			if(agent->ownsPolicy) {
+				publishPolicy(agent);
+			}
+		}
+		return;
+	}
 
-		//std::vector<torch::Tensor> av = agent->model->get()->forward(mini_states, false); // action value pairs
+	// Wait for the previous optimization, its training rollouts are reused. 
+	waitForLearner();
+	// Publish its weights now, while the learner is idle. A flag left for "runPolicies" would be consumed while the learner already runs the next optimization. 
+	publishOutdatedPolicies();
 
-		double beta = getTrainingParameters()->ppo_beta;
+	// Swap buffers. The actors continue on the (emptied) rollouts, the learner optimizes the just finished ones. 
+	for(Agent* agent : agentsToOptimize) {
+		std::swap(agent->rollout, agent->trainingRollout);
+		agent->rollout->clear();
+	}
 
-		std::tuple<torch::Tensor, torch::Tensor> av = agent->model->get()->forward(mini_states, false); // action value pairs
-		torch::Tensor action = std::get<0>(av);
-		torch::Tensor entropy = agent->model->get()->entropy().mean();
-		torch::Tensor new_log_prob = agent->model->get()->logProb(mini_actions);
+	// Wake learner. 
+	learnerMutex.lock();
+	learnerAgents = agentsToOptimize;
+	learnerMutex.unlock();
+	learnerCondition.notify_all();
+}
 
-		torch::Tensor old_log_prob = mini_logProbs;
-		torch::Tensor ratio = (new_log_prob - old_log_prob).exp();
-		torch::Tensor surr1 = ratio * mini_advantages;	//  ratio is { 30, 6 }, mini_advantages is { 30, 1 }. 
-		torch::Tensor surr2 = torch::clamp(ratio, 1.0 - beta, 1.0 + beta) * mini_advantages;
+void TrainingController::waitForLearner() {
+	std::unique_lock<std::mutex> lock(learnerMutex);
+	learnerCondition.wait(lock, [this]() { return learnerAgents.empty(); });
+}
 
-		torch::Tensor val = std::get<1>(av);
-		torch::Tensor actorLoss = -torch::min(surr1, surr2).mean();
-		torch::Tensor criticLoss = (mini_returns - val).pow(2).mean();
+void TrainingController::publishPolicy(Agent* agent) {
+	// Nothing to copy for a synchronous learner. 
+	if(agent->actorModel != agent->model) {
+		// Keep the optimizer state matching the published weights for checkpoints (see saveAgents). The state of a loaded checkpoint has to be part of it. 
+		loadDeferredOptimizerStates();
+		PolicySnapshot::serializeOptimizer(agent->optimizer, agent->publishedOptimizerState);
 
-		// Calculate total loss. 
-		torch::Tensor totalLoss = 0.5 * criticLoss + actorLoss - getTrainingParameters()->ppo_gamma * entropy;
+		torch::NoGradGuard noGrad;
+		std::vector<torch::Tensor> source = agent->model->get()->parameters();
+		std::vector<torch::Tensor> target = agent->actorModel->get()->parameters();
+		for(size_t i = 0; i < source.size(); i++) {
+			target[i].copy_(source[i]);
+		}
+		source = agent->model->get()->buffers();
+		target = agent->actorModel->get()->buffers();
+		for(size_t i = 0; i < source.size(); i++) {
+			target[i].copy_(source[i]);
+		}
+	}
+	if(agent->fastActor != nullptr && !agent->fastActor->snapshot(*agent->actorModel->get())) {
+		consoleOut("TrainingController::publishPolicy: The model isn't supported by FastActorCritic, the actors use the torch module.");
+	}
+}
 
-		// Lock mutex because of potentially asynchronous backward call
-		backwardMutex.lock();
+void TrainingController::publishOutdatedPolicies() {
+	// The flag is only set once an optimization is done and consumed by "optimizeAgents" before the next one starts, so the learner is idle if it is set. 
+	if(policiesOutdated.exchange(false)) {
+		for(Agent* agent : agents) {
+			if(agent->ownsPolicy) {
+				publishPolicy(agent);
+			}
+		}
+	}
+}
 
-		//agent->model->get()->actor.get()->weight.dim();
-		//float f_1 = agent->model->get()->actor.get()->weight[0][0].item().toFloat();
-		//float f_1 = agent->model->get()->a_lin3_->weight[0][0].item().toFloat();
-		//float loss = totalLoss.item().toFloat();
+void TrainingController::optimizePolicies(const std::vector<Agent*>& agentsToOptimize, bool useTrainingRollouts) {
+	std::vector<const RolloutBuffer*> rollouts;
+	for(Agent* owner : agentsToOptimize) {
+		if(!owner->ownsPolicy) {
+			continue;
+		}
+		rollouts.clear();
+		for(Agent* agent : agentsToOptimize) {
+			if(agent->model == owner->model) {
+				rollouts.push_back(useTrainingRollouts ? agent->trainingRollout : agent->rollout);
+			}
+		}
+		optimizePPO(owner, rollouts);
+	}
+}
 
-		// Update model. 
-		agent->optimizer->zero_grad();
-		//torch::Tensor tt = totalLoss.grad();
-		if(i != getTrainingParameters()->ppo_epochs - 1) {
-			// Retain graph if this is not the last ppo_epoch. 
-			totalLoss.backward({}, true);
-		} else {
-			// This is the last ppo_epoch, don't retain the graph. 
-			totalLoss.backward({}, false);
+void TrainingController::optimizePPO(Agent* agent, const std::vector<const RolloutBuffer*>& rollouts) {
+
+	// The optimizer state of a mapped checkpoint is loaded on the first optimization. Only the caller accesses the optimizers now. 
+	loadDeferredOptimizerStates();
+
+	uint32_t numOfSteps = 0;
+	double totalReward = 0.0;
+	for(const RolloutBuffer* rollout : rollouts) {
+		numOfSteps += static_cast<uint32_t>(rollout->rewards.size());
+		totalReward += rollout->totalReward;
+	}
+	consoleOut("TrainingController::optimizePPO: Agent " + std::to_string(agent->agentID) + ", rollouts: " + std::to_string(rollouts.size()) + ", total reward: " + std::to_string(totalReward), false);
+	if(numOfSteps == 0) {
+		return;	// Nothing collected. 
+	}
+
+	// Calculate the returns and advantages on the raw data. The rollouts are concatenated, each one is a trajectory of its own (their lengths may differ). 
+	torch::Tensor t_returns = torch::empty({ numOfSteps }, getTensorOptionsCPU());
+	torch::Tensor t_advantages = torch::empty({ numOfSteps }, getTensorOptionsCPU());
+	std::vector<float> rewards;
+	std::vector<torch::Tensor> statesList;
+	std::vector<torch::Tensor> actionsList;
+	std::vector<torch::Tensor> logProbsList;
+	uint32_t offset = 0;
+	for(const RolloutBuffer* rollout : rollouts) {
+		uint32_t rolloutSteps = static_cast<uint32_t>(rollout->rewards.size());
+		if(rolloutSteps == 0) {
+			continue;
 		}
-		//torch::Tensor tt_2 = totalLoss.grad();
-		agent->optimizer->step();
+		rewards.assign(rollout->rewards.begin(), rollout->rewards.end());
+		torch::Tensor t_values = rollout->getValues().narrow(0, 0, rolloutSteps);
+		TrainingGAE::computeReturns(rewards.data(), t_values.data_ptr<float>(), rolloutSteps, 1, getTrainingParameters()->ppo_gamma, getTrainingParameters()->ppo_lambda, t_returns.data_ptr<float>() + offset, t_advantages.data_ptr<float>() + offset);
+
+		statesList.push_back(rollout->getStates().narrow(0, 0, rolloutSteps));
+		actionsList.push_back(rollout->getActions().narrow(0, 0, rolloutSteps));
+		logProbsList.push_back(rollout->getLogProbs().narrow(0, 0, rolloutSteps));
+		offset += rolloutSteps;
+	}
 
-		//float f_2 = agent->model->get()->actor.get()->weight[0][0].item().toFloat();
-		//float f_2 = agent->model->get()->a_lin3_->weight[0][0].item().toFloat();
+	// Build copies of tensors. 
+	torch::Tensor t_logProbs = torch::cat(logProbsList);
+	torch::Tensor t_states = torch::cat(statesList);
+	torch::Tensor t_actions = torch::cat(actionsList);
+
+	// Move samples to the device once. Shape all per sample values as { samples, 1 }. 
+	torch::Device device = getTensorOptions().device();
+	t_states = t_states.to(device);
+	t_actions = t_actions.unsqueeze(1).to(device);
+	t_logProbs = t_logProbs.to(device);
+	t_returns = t_returns.unsqueeze(1).to(device);
+	t_advantages = t_advantages.unsqueeze(1).to(device);
 
-		// Unlock mutex. 
-		backwardMutex.unlock();
+	// NOTE: From here the sources are https://github.com/mhubii/ppo_libtorch/tree/master and https://github.com/ericyangyu/PPO-for-Beginners. 
+	MiniBatchSampler sampler = MiniBatchSampler(numOfSteps, getTrainingParameters()->ppo_miniBatches, getTrainingParameters()->ppo_shuffleSamples, device);
+	torch::Tensor mini_states;
+	torch::Tensor mini_actions;
+	torch::Tensor mini_logProbs;
+	torch::Tensor mini_returns;
+	torch::Tensor mini_advantages;
+	for(uint32_t i = 0; i < getTrainingParameters()->ppo_epochs; i++) {
+		sampler.nextEpoch();
+		for(uint32_t m = 0; m < sampler.getNumOfMiniBatches(); m++) {
+			// Construct mini batch. 
+			mini_states = sampler.gather(t_states, m);
+			mini_actions = sampler.gather(t_actions, m);
+			mini_logProbs = sampler.gather(t_logProbs, m);
+			mini_returns = sampler.gather(t_returns, m);
+			mini_advantages = sampler.gather(t_advantages, m);
+
+			double beta = getTrainingParameters()->ppo_beta;
+
+			std::tuple<torch::Tensor, torch::Tensor> av = agent->model->get()->forward(mini_states, false); // action value pairs
+			torch::Tensor action = std::get<0>(av);
+			torch::Tensor entropy = agent->model->get()->entropy().mean();
+			torch::Tensor new_log_prob = agent->model->get()->logProb(mini_actions);
+
+			torch::Tensor old_log_prob = mini_logProbs;
+			torch::Tensor ratio = (new_log_prob - old_log_prob).exp();
+			torch::Tensor surr1 = ratio * mini_advantages;	//  ratio is { 30, 6 }, mini_advantages is { 30, 1 }. 
+			torch::Tensor surr2 = torch::clamp(ratio, 1.0 - beta, 1.0 + beta) * mini_advantages;
+
+			torch::Tensor val = std::get<1>(av);
+			torch::Tensor actorLoss = -torch::min(surr1, surr2).mean();
+			torch::Tensor criticLoss = (mini_returns - val).pow(2).mean();
+
+			// Calculate total loss. 
+			torch::Tensor totalLoss = 0.5 * criticLoss + actorLoss - getTrainingParameters()->ppo_gamma * entropy;
+
+			// Lock mutex because of potentially asynchronous backward call
+			backwardMutex.lock();
+
+			//agent->model->get()->actor.get()->weight.dim();
+			//float f_1 = agent->model->get()->actor.get()->weight[0][0].item().toFloat();
+			//float f_1 = agent->model->get()->a_lin3_->weight[0][0].item().toFloat();
+			//float loss = totalLoss.item().toFloat();
+
+			// Update model. 
+			agent->optimizer->zero_grad();
+			//torch::Tensor tt = totalLoss.grad();
+			// Every mini batch builds its own graph by its forward pass, so it doesn't have to be retained. 
+			totalLoss.backward();
+			//torch::Tensor tt_2 = totalLoss.grad();
+			agent->optimizer->step();
+
+			//float f_2 = agent->model->get()->actor.get()->weight[0][0].item().toFloat();
+			//float f_2 = agent->model->get()->a_lin3_->weight[0][0].item().toFloat();
+
+			// Unlock mutex. 
+			backwardMutex.unlock();
+		}
 	}
 }
 
@@ -492,3 +718,39 @@ void TrainingController::updateVMEpisodeCount(uint32_t episodeCount) const {
 // PRIVATE
 
 TrainingController* TrainingController::instance = nullptr;
+
+void TrainingController::learnerLoop() {
+	std::vector<Agent*> agentsToOptimize;
+	while(true) {
+		// Wait for training rollouts. 
+		std::unique_lock<std::mutex> lock(learnerMutex);
+		learnerCondition.wait(lock, [this]() { return learnerStopping || !learnerAgents.empty(); });
+		if(learnerAgents.empty()) {
+			return;	// Stopping and nothing left to optimize. 
+		}
+		agentsToOptimize = learnerAgents;
+		lock.unlock();
+
+		optimizePolicies(agentsToOptimize, true);
+		// Let the actors pick up the new weights. 
+		policiesOutdated.store(true);
+
+		// Become idle. 
+		lock.lock();
+		learnerAgents.clear();
+		lock.unlock();
+		learnerCondition.notify_all();
+	}
+}
+
+void TrainingController::stopLearner() {
+	if(!learnerThread.joinable()) {
+		return;
+	}
+	// A running optimization is finished first. 
+	learnerMutex.lock();
+	learnerStopping = true;
+	learnerMutex.unlock();
+	learnerCondition.notify_all();
+	learnerThread.join();
+}
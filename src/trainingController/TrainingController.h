@@ -1,8 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
 
 #include "../Models.h"
+#include "../RolloutBuffer.h"
 #include "../util/Serialization.h"
 
 namespace PLANS {
@@ -18,26 +24,34 @@ namespace PLANS {
 	// Determine which optimizer to use. 
 	using Optimizer = torch::optim::Adam;
 
+	class TensorCheckpoint;
+	class FastActorCritic;
+
 	//############################ Agent ############################
 	
 	class Agent {
 		public:
-			Agent(AGENT_ID agentID);
+			// If "policyAgent" is given, the model and optimizer of that agent are shared instead of creating own ones (see TrainingParameters::numOfEnvironments). 
+			Agent(AGENT_ID agentID, Agent* policyAgent = nullptr);
 			~Agent();
 		protected:
 		private:
 			AGENT_ID agentID;
 
-			Model* model;
+			Model* model;			// Trained by the optimizer. 
+			Model* actorModel;		// Used to collect rollouts. Equals "model", unless the learner runs asynchronously (see TrainingParameters::asyncLearner). 
 			Optimizer* optimizer;
-
-			std::vector<torch::Tensor> states;		// Tensors of size { LSTM_INPUT_SIZE }. 
-			std::vector<torch::Tensor> actions;		// Tensors of size { 1 }. 
-			std::vector<torch::Tensor> logProbs;
-			std::vector<torch::Tensor> values;
-			std::vector<double> rewards;
-			double totalReward;
-			uint32_t rewardsCount;
+			FastActorCritic* fastActor;	// Evaluates "actorModel" on the CPU without torch (see TrainingParameters::fastInference), nullptr if not used. 
+			bool ownsPolicy;	// Whether "model", "actorModel", "fastActor" and "optimizer" belong to this agent. Only owned policies are saved to / loaded from checkpoints. 
+			std::shared_ptr<TensorCheckpoint> deferredCheckpoint;	// Checkpoint whose optimizer state isn't loaded yet (see TrainingController::loadDeferredOptimizerStates). 
+			uint32_t deferredPolicyIndex;
+
+			RolloutBuffer* rollout;				// Filled by the actor. 
+			RolloutBuffer* trainingRollout;		// Optimized by the learner thread while "rollout" is filled (double buffer). 
+			std::vector<int8_t> publishedOptimizerState;	// Optimizer state matching "actorModel" (see PolicySnapshot::serializeOptimizer). Only used, if the learner runs asynchronously. 
+			uint32_t episodeStartIndex;		// Index of the first reward of the current episode in "rollout->rewards". 
+			double episodeReward;			// Sum of all rewards of the current episode. 
+			uint32_t episodeSteps;			// Number of rewarded steps of the current episode. 
 
 			friend class TrainingController;
 			friend class TrainingControllerContinuous;
@@ -59,9 +73,14 @@ namespace PLANS {
 
 	struct TrainingParameters;
 	class Environment;
+	class CheckpointWriter;
+	class StateArena;
 	
 	class TrainingController {
 		public:
+			static const uint32_t NO_STATE_DATA_SLOT = UINT32_MAX;
+			static const uint32_t MAX_INITIAL_ROLLOUT_CAPACITY = 1U << 16;	// Steps preallocated per rollout buffer at most. Longer rollouts double the capacity (see RolloutBuffer). 
+
 			static TrainingController* getInstance();
 
 			virtual ~TrainingController();
@@ -78,14 +97,26 @@ namespace PLANS {
 			// Creates a state tensor for the current step index in the perspective of the given faction. 
 			virtual bool onActionRequired(AGENT_ID agentID, std::vector<torch::Tensor>& output) = 0;
 
+			// Called from Main.cpp once per tick instead of "onActionRequired" for every agent. Fills "outputs[agentID]" like "onActionRequired" does, an empty output means that the agent takes no action. 
+			// Calls "onActionRequired" for each agent by default. 
+			virtual void onActionsRequired(std::vector<std::vector<torch::Tensor>>& outputs);
+
 			// Called from NPC::executeInternal (when the npc sucessfully executed and the events will be deleted next). 
 			virtual void onAgentExecuted(AGENT_ID agentID) = 0;
 
+			// Called from Main.cpp once the environment executed the actions of all given agents in this tick (barrier, all instances stepped). 
+			// Calls "onAgentExecuted" for each of the agents by default. 
+			virtual void onAgentsExecuted(const std::vector<AGENT_ID>& agentIDs);
+
+			// Called from Main.cpp when the environment instance of a single agent reached game over on its own (see Environment::agentGameOver). 
+			// Ends the episode of this agent only, the other agents continue. Returns whether the maximum episode count has been reached. 
+			virtual bool onAgentEpisodeEnded(AGENT_ID agentID) = 0;
+
 			// Called after LockStepManagerTrainer::update from StateGame::update. 
 			// Indicates, that the reward for the passed game tick can be calculated. Returns whether the episode should be terminated. 
 			virtual bool onGameTickPassed() = 0;
 
-			// Called from TrainMain.cpp. 
+			// Called from TrainMain.cpp. Waits for the learner thread and pending checkpoints to finish first. 
 			void cleanUp();
 
 			void consoleOut(const std::string& output, bool regardVerbosity = true) const;
@@ -97,6 +128,8 @@ namespace PLANS {
 			bool isVerbose() const;
 			uint32_t getTrainedEpisodes() const;
 			uint32_t getStepsInThisEpisode() const;
+			// Returns how many steps an agent collects between two optimizations at most. Used to size the rollout buffers. 
+			virtual uint32_t getRolloutCapacity() const = 0;
 		protected:
 			TrainingController(TrainingParameters* parameters, Environment* enviroment);
 
@@ -109,21 +142,45 @@ namespace PLANS {
 
 			void initAgents(uint32_t numOfAgents);
 			std::vector<Agent*>& getAgents();
+			const std::vector<AGENT_ID>& getAgentIDs() const;
 
-			void addStateData(AGENT_ID agentID, const StateData* stateData);
+			// Returns nullptr, if the agent has no state data for the given step. Only the state datas of the current step are kept. 
 			const StateData* getStateData(AGENT_ID agentID, uint32_t stepIndex);
-			std::vector<std::vector<StateData*>>& getStateDatas();
+			// The first call of a step builds the state datas of all agents. Not thread-safe, only called by the game loop thread (see runPolicies), so no locking is required. 
 			const StateData* getOrCreateStateData(AGENT_ID agentID);
+			// Not thread-safe, only called between episodes. 
 			void cleanUpStateDatas();
 
 			void ensureRequiredDirectories() const;
-			void serializeAgent(Agent* agent, const std::string& tmpFilePath, AEX::Serializer& serializer);
-			void saveAgents(uint32_t episode, std::string& checkpointFilePath);	// SLOW. 
-			void deserializeAgent(Agent* agent, const std::string& tmpFilePath, AEX::Deserializer& deserializer);
-			uint32_t loadAgents();	// SLOW. 
-
-			// Optimizes the given agent based on the PPO algorithm. 
-			void optimizePPO(Agent* agent);
+			// Takes snapshots of the owned policies and hands them to the checkpoint writer, which writes the checkpoint in the background. 
+			// Doesn't wait for the learner thread, the published policies are saved then. Only blocks while too many checkpoints are pending (see TrainingParameters::maxPendingCheckpoints). 
+			void saveAgents(uint32_t episode, std::string& checkpointFilePath);
+			// Loads model and optimizer of the given agent directly from the data of the deserializer. 
+			void deserializeAgent(Agent* agent, AEX::Deserializer& deserializer);
+			uint32_t loadAgents();	// SLOW (except for mapped checkpoints). 
+			// Loads the optimizer states, which have been deferred while loading a mapped or delta checkpoint. Called before the optimizers are used or saved. 
+			void loadDeferredOptimizerStates();
+
+			// Runs the policies of the given agents. Agents sharing a policy are evaluated by a single forward pass over the batch of their inputs. 
+			// Saves state, action, logProb and value of every agent and fills "outputs[i]" with the actor output and the critic output of agent "agentIDs[i]" (both on the CPU). 
+			// The outputs of all agents sharing a policy are copied from the device at once, so there is one synchronization per policy instead of one per output. 
+			// The policies are evaluated under torch::InferenceMode, the gradients are only computed by the forward passes of "optimizePPO". 
+			void runPolicies(const std::vector<AGENT_ID>& agentIDs, std::vector<std::vector<torch::Tensor>>& outputs);
+
+			// Optimizes the given agents on their current rollouts. Afterwards the agents can start their next rollouts. 
+			// If the learner runs asynchronously, the rollouts are swapped with the training rollouts and handed to the learner thread. Only waits for the previous optimization to finish then. 
+			void optimizeAgents(const std::vector<Agent*>& agentsToOptimize);
+			// Blocks until the learner thread is idle. Required before accessing "model" or "optimizer" of an agent. 
+			void waitForLearner();
+			// Copies the weights of the model of the given agent to its actor model (if they differ) and refreshes the snapshot of its fast actor. 
+			// Requires an idle learner thread. 
+			void publishPolicy(Agent* agent);
+			// Publishes the policies of all agents, if the learner thread finished an optimization since the last call. Only called by the game loop thread. 
+			void publishOutdatedPolicies();
+			// Optimizes every policy owned by one of the given agents once, on the combined rollouts (or training rollouts) of all given agents sharing it. 
+			void optimizePolicies(const std::vector<Agent*>& agentsToOptimize, bool useTrainingRollouts);
+			// Optimizes the policy of the given agent on the given rollouts based on the PPO algorithm. The returns are computed per rollout. 
+			void optimizePPO(Agent* agent, const std::vector<const RolloutBuffer*>& rollouts);
 
 			void updateVMEpisodeCount(uint32_t episodeCount) const;
 		private:
@@ -140,9 +197,23 @@ namespace PLANS {
 			uint32_t stepsInThisEpisode;
 			std::mutex backwardMutex;
 			std::vector<Agent*> agents;
+			std::vector<AGENT_ID> agentIDs;		// IDs of all agents in ascending order. 
+
+			StateData* const* stateDatas;	// State datas of all agents for the step of "builtStateDataSlot", indexed by agent ID. nullptr if none. Owned by "stateArena". 
+			uint32_t builtStateDataSlot;	// "stepIndex + 1" of the step whose state datas have been built last (the first step of an episode may be -1, see setStepsInThisEpisode), NO_STATE_DATA_SLOT if none. 
+			StateArena* stateArena;
+
+			std::thread learnerThread;
+			std::mutex learnerMutex;
+			std::condition_variable learnerCondition;
+			std::vector<Agent*> learnerAgents;		// Agents whose training rollouts are optimized by the learner thread. Empty while the learner is idle. 
+			bool learnerStopping;
+			std::atomic<bool> policiesOutdated;		// Set by the learner thread once the actor models have to be updated. 
+
+			CheckpointWriter* checkpointWriter;
 
-			std::vector<std::vector<StateData*>> stateDatas;
-			std::mutex stateDataMutex;
+			void learnerLoop();
+			void stopLearner();
 	};
 
 }
@@ -28,24 +28,11 @@ bool TrainingControllerContinuous::onNextScenarioRequired(bool isInit) {
 	consoleOut("TrainingControllerContinuous::onNextScenarioRequired");
 
 	if(!isInit) {
-		setTrainedEpisodes(getTrainedEpisodes() + 1);
-
-		TrainingController::updateVMEpisodeCount(getTrainedEpisodes());
-
-		// Check if a checkpoint should be created. 
-		if(episodesTillCheckpoint != UINT32_MAX && --episodesTillCheckpoint == 0) {
-			// Save agents as episode ended. 
-			std::string checkpointFilePath;
-			saveAgents(getTrainedEpisodes(), checkpointFilePath);
-			// Log. 
-			TrainingLogger::onCheckpointCreated(checkpointFilePath, getTrainedEpisodes());
-
-			episodesTillCheckpoint = getTrainingParameters()->episodesPerCheckpoint;
-		}
+		onEpisodeFinished();
 	}
 
 	// Check if episode limit reached. If so, terminate training. 
-	if(getTrainedEpisodes() >= getTrainingParameters()->maxEpisodes && getTrainingParameters()->maxEpisodes > 0) {
+	if(maxEpisodesReached()) {
 		return true;	// Terminate. Maximum episode count reached. 
 	}
 
@@ -68,68 +55,41 @@ bool TrainingControllerContinuous::onActionRequired(AGENT_ID agentID, std::vecto
 		return false;	// Not allowed in this step. 
 	}
 
-	// Get agent. 
-	Agent* agent = getAgents()[agentID];
-
-#if defined(_DEBUG) and defined(MEASURE_TIME)
-	auto start = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-#endif
-
-	// Get or create state data. 
-	const StateData* stateData = TrainingController::getOrCreateStateData(agentID);
-
-	// Save input tensor (state tensor). 
-	agent->states.push_back(stateData->inputTensor);
-
-	// Pass inputs into model to produce actor and critic outputs. 
-	std::tuple<torch::Tensor, torch::Tensor> outputTuple = agent->model->get()->forward(stateData->inputTensorDevice, true);
-
-#if defined(_DEBUG) and defined(MEASURE_TIME)
-	auto finish = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-	auto total = finish - start;
-	std::cout << "[" + std::to_string(agentID) + "] ran from " + std::to_string(start) + " to " + std::to_string(finish) + "(total of " + std::to_string(total) + ")" << std::endl;
-#endif
-
-	// Extract actual output (vector index, sequence, batch). 
-	torch::Tensor actorOutput = std::get<0>(outputTuple)[0];
-	torch::Tensor criticOutput = std::get<1>(outputTuple)[0];
-
-	// Save action returned by the actor (just the action type at index 0). 
-	agent->actions.push_back(torch::full(1, actorOutput[0].item()));
+	// Run policy of this agent only. 
+	std::vector<std::vector<torch::Tensor>> outputs = std::vector<std::vector<torch::Tensor>>(1);
+	runPolicies({ agentID }, outputs);
+	output.insert(output.end(), outputs[0].begin(), outputs[0].end());
 
-	// Create and save logProb. 
-	torch::Tensor logProb = agent->model->get()->logProb(actorOutput[0]);
-	agent->logProbs.push_back(logProb);
+	// Reward agent. 
+	rewardAgentForOutput(getAgents()[agentID], output);
 
-	// Save value returned by the critic. 
-	agent->values.push_back(criticOutput);
-
-	// Copy output tensor to CPU for faster access while decoding. 
-	actorOutput = actorOutput.to(torch::kCPU);
-
-	// Process outputs to action. 
-	uint32_t delay = 0;
-	float action = TrainingEncoder::decodeAction(agent->agentID, actorOutput);
+	return true;
+}
 
-	// Reward agent. Accumulate rewards from occured events, which will be deleted now. 
-	rewardAgent(agent, action != UINT8_MAX, getEnvironment());
+void TrainingControllerContinuous::onActionsRequired(std::vector<std::vector<torch::Tensor>>& outputs) {
+	// Check wether action is allowed (policy step). All agents act in the same steps. 
+	if(stepsTillAction != 0) {
+		return;	// Not allowed in this step. 
+	}
 
-	// Fill output vector. 
-	output.push_back(actorOutput);
-	output.push_back(criticOutput);
+	// Run the policies of all agents batched. 
+	runPolicies(getAgentIDs(), outputs);
 
-	return true;
+	// Reward agents. 
+	for(AGENT_ID agentID : getAgentIDs()) {
+		rewardAgentForOutput(getAgents()[agentID], outputs[agentID]);
+	}
 }
 
 void TrainingControllerContinuous::onAgentExecuted(AGENT_ID agentID) {
 	// Get agent. 
 	Agent* agent = getAgents()[agentID];
 
-	if(agent->rewards.size() < getTrainingParameters()->trainingStepLength) {
+	if(agent->rollout->rewards.size() < getTrainingParameters()->trainingStepLength) {
 		return;	// Not enough rewards. 
 	}
 
-	if(agent->totalReward != 0.0) {
+	if(agent->rollout->totalReward != 0.0) {
 
 #ifdef _DEBUG
 		//float f_1 = agent->model->get()->a_lin1_->weight[0][0].item().toFloat();
@@ -143,8 +103,9 @@ void TrainingControllerContinuous::onAgentExecuted(AGENT_ID agentID) {
 		}
 #endif
 
-		// Optimize the agent based on the PPO algorithm. 
-		optimizePPO(agent);
+		// Optimize the agent based on the PPO algorithm. Always synchronous here, as the agents are optimized independently. 
+		optimizePPO(agent, { agent->rollout });
+		publishPolicy(agent);
 
 #ifdef _DEBUG
 		//float f_2 = agent->model->get()->a_lin1_->weight[0][0].item().toFloat();
@@ -178,8 +139,9 @@ void TrainingControllerContinuous::onAgentExecuted(AGENT_ID agentID) {
 #ifdef _DEBUG
 	// Count actions. 
 	std::vector<uint32_t> actionCounts = std::vector<uint32_t>(5);
-	for(uint32_t i = 0; i < agent->actions.size(); i++) {
-		uint32_t action = static_cast<uint32_t>(agent->actions[i].item().toInt());
+	torch::Tensor actions = agent->rollout->getActions();
+	for(uint32_t i = 0; i < agent->rollout->getNumOfSteps(); i++) {
+		uint32_t action = static_cast<uint32_t>(actions[i].item().toInt());
 		if(action < 4) {
 			actionCounts[action]++;
 		} else {
@@ -198,6 +160,14 @@ void TrainingControllerContinuous::onAgentExecuted(AGENT_ID agentID) {
 	//c10::cuda::CUDACachingAllocator::emptyCache();
 }
 
+bool TrainingControllerContinuous::onAgentEpisodeEnded(AGENT_ID agentID) {
+	// Agents are optimized continuously, so the episode of a single agent only counts towards the episode schedules. 
+	onEpisodeFinished();
+
+	// Check if episode limit reached. If so, terminate training. 
+	return maxEpisodesReached();
+}
+
 bool TrainingControllerContinuous::onGameTickPassed() {
 	// Update stepsTillAction. 
 	if(getTrainingParameters()->policyStepLength > 1) {
@@ -220,6 +190,10 @@ bool TrainingControllerContinuous::onGameTickPassed() {
 
 // PROTECTED
 
+uint32_t TrainingControllerContinuous::getRolloutCapacity() const {
+	return getTrainingParameters()->trainingStepLength;
+}
+
 bool TrainingControllerContinuous::initInternal() {
 	setTrainedEpisodes(0);
 
@@ -227,11 +201,6 @@ bool TrainingControllerContinuous::initInternal() {
 	setVerbose(true);
 #endif
 
-	// Pre-fill state datas. 
-	for(uint32_t i = 0; i < NUM_OF_AGENTS; i++) {
-		getStateDatas().push_back(std::vector<StateData*>());
-	}
-
 	initAgents(NUM_OF_AGENTS);
 
 	setStepsInThisEpisode(-1);
@@ -271,17 +240,40 @@ void TrainingControllerContinuous::rewardAgent(Agent* agent, bool didTakeAction,
 #endif
 
 	// Add reward. 
-	agent->rewards.push_back(reward);
-	agent->totalReward += reward;
-	agent->rewardsCount++;
+	agent->rollout->rewards.push_back(reward);
+	agent->rollout->totalReward += reward;
+	agent->rollout->rewardsCount++;
+}
+
+void TrainingControllerContinuous::rewardAgentForOutput(Agent* agent, const std::vector<torch::Tensor>& output) {
+	// Process outputs to action. 
+	float action = TrainingEncoder::decodeAction(agent->agentID, output[0]);
+
+	// Reward agent. Accumulate rewards from occured events, which will be deleted now. 
+	rewardAgent(agent, action != UINT8_MAX, getEnvironment());
+}
+
+void TrainingControllerContinuous::onEpisodeFinished() {
+	setTrainedEpisodes(getTrainedEpisodes() + 1);
+
+	TrainingController::updateVMEpisodeCount(getTrainedEpisodes());
+
+	// Check if a checkpoint should be created. 
+	if(episodesTillCheckpoint != UINT32_MAX && --episodesTillCheckpoint == 0) {
+		// Save agents as episode ended. 
+		std::string checkpointFilePath;
+		saveAgents(getTrainedEpisodes(), checkpointFilePath);
+		// Log. 
+		TrainingLogger::onCheckpointCreated(checkpointFilePath, getTrainedEpisodes());
+
+		episodesTillCheckpoint = getTrainingParameters()->episodesPerCheckpoint;
+	}
+}
+
+bool TrainingControllerContinuous::maxEpisodesReached() const {
+	return getTrainedEpisodes() >= getTrainingParameters()->maxEpisodes && getTrainingParameters()->maxEpisodes > 0;
 }
 
 void TrainingControllerContinuous::resetAgentTrainingStep(Agent* agent) {
-	agent->states.clear();
-	agent->actions.clear();
-	agent->values.clear();
-	agent->logProbs.clear();
-	agent->rewards.clear();
-	agent->totalReward = 0.0;
-	agent->rewardsCount = 0;
+	agent->rollout->clear();
 }
@@ -16,9 +16,16 @@ namespace PLANS {
 
 			virtual bool onActionRequired(AGENT_ID agentID, std::vector<torch::Tensor>& output) final override;
 
+			virtual void onActionsRequired(std::vector<std::vector<torch::Tensor>>& outputs) final override;
+
 			virtual void onAgentExecuted(AGENT_ID agentID) final override;
 
+			virtual bool onAgentEpisodeEnded(AGENT_ID agentID) final override;
+
 			virtual bool onGameTickPassed() final override;
+
+			// "trainingStepLength" counts steps here. 
+			virtual uint32_t getRolloutCapacity() const final override;
 		protected:
 			virtual bool initInternal() final override;
 			virtual void cleanUpInternal() final override;
@@ -27,6 +34,11 @@ namespace PLANS {
 			uint32_t episodesTillCheckpoint;
 
 			void rewardAgent(Agent* agent, bool didTakeAction, Environment* enviroment);
+			// Decodes the action from the output of the agents policy and rewards the agent. 
+			void rewardAgentForOutput(Agent* agent, const std::vector<torch::Tensor>& output);
+			// Increases "trainedEpisodes" and runs the checkpoint schedule. 
+			void onEpisodeFinished();
+			bool maxEpisodesReached() const;
 			// Called after every optimizer step to reset the rewards and values of the agents. 
 			void resetAgentTrainingStep(Agent* agent);
 	};
@@ -20,86 +20,23 @@ bool TrainingControllerEpisodic::onNextScenarioRequired(bool isInit) {
 		episodesTillOptimization = getTrainingParameters()->trainingStepLength;
 
 	} else {
-		// An episode ended. 
-		setTrainedEpisodes(getTrainedEpisodes() + 1);
-
-		// Log episode reward of agents and maybe manipulate reward values. 
+		// The scenario ended, so the running episode of every agent ends. Each one counts as an episode of its own. 
+		// Agents whose episode already ended in this tick (see onAgentEpisodeEnded) haven't started a new one yet and are skipped. 
+		uint32_t numOfEpisodes = 0;
 		for(Agent* agent : getAgents()) {
-			// Count rewards in this episode ("episode reward"). 
-			double episodeReward = 0.0;
-			for(uint32_t i = 0; i < getStepsInThisEpisode(); i++) {
-				episodeReward += agent->rewards[agent->rewardsCount - getStepsInThisEpisode() + i];
-			}
-
-			// If agents ID is 0, post average of last 100 episode rewards. 
-			if(agent->agentID == 0) {
-				lastEpisodeRewards.add(episodeReward);
-				if(lastEpisodeRewards.size() > 100) {
-					// Remove oldest value. 
-					lastEpisodeRewards.removeIndex(0);
-					// Calculate average. 
-					double average = calculateAverage(lastEpisodeRewards);
-					// Post average. 
-					HTTPHelper::postRewardAverage(average);
-				}
-			}
-
-			// Log episode rewards. 
-			TrainingLogger::onAgentRewarded(agent->agentID, episodeReward);
-
-			// If the environment only gives a reward at the end, modify reward values. 
-			if(getEnvironment()->onlyFinalReward() && episodeReward > 0.0) {
-				// Set reward for all steps in this episode to the episode reward. 
-				for(uint32_t i = 0; i < getStepsInThisEpisode(); i++) {
-					agent->rewards[agent->rewardsCount - getStepsInThisEpisode() - 1 + i] = episodeReward;
-				}
+			if(agent->episodeSteps > 0) {
+				// Log episode reward of agent and maybe manipulate reward values. 
+				finishAgentEpisode(agent);
+				numOfEpisodes++;
 			}
 		}
+		setTrainedEpisodes(getTrainedEpisodes() + numOfEpisodes);
 
-		episodesTillOptimization--;
-		// Check whether its time for an optimization step. 
-		if(episodesTillOptimization == 0) {
-			// Optimization step. 
-			// Optimize agents. 
-			for(Agent* agent : getAgents()) {
-
-				//if(agent->totalReward != 0.0) {
-					// Optimize agent. 
-					optimizePPO(agent);
-					// Log total reward. 
-					TrainingLogger::onAgentTrained(agent->agentID, agent->totalReward);
-				//} else {
-				//	consoleOut("TrainingControllerContinuous::onAgentExecuted: Not optimizing agent " + std::to_string(agent->agentID) + ", because his total reward is 0.0.", false);
-				//}
-
-				// Update VM episode count. 
-				TrainingController::updateVMEpisodeCount(getTrainedEpisodes());
-
-				// Reset agent. 
-				resetAgentTrainingStep(agent);
-			}
-
-			// Clean up state datas. 
-			TrainingController::cleanUpStateDatas();
-
-			// Reset optimization counter. 
-			episodesTillOptimization = getTrainingParameters()->trainingStepLength;
-		}
-
-		// Check if a checkpoint should be created. 
-		if(episodesTillCheckpoint != UINT32_MAX && --episodesTillCheckpoint == 0) {
-			// Save agents as episode ended. 
-			std::string checkpointFilePath;
-			saveAgents(getTrainedEpisodes(), checkpointFilePath);
-			// Log. 
-			TrainingLogger::onCheckpointCreated(checkpointFilePath, getTrainedEpisodes());
-
-			episodesTillCheckpoint = getTrainingParameters()->episodesPerCheckpoint;
-		}
+		onEpisodesFinished(numOfEpisodes);
 	}
 
 	// Check if episode limit reached. If so, terminate training. 
-	if(getTrainedEpisodes() >= getTrainingParameters()->maxEpisodes && getTrainingParameters()->maxEpisodes > 0) {
+	if(maxEpisodesReached()) {
 		return true;	// Terminate. Maximum episode count reached. 
 	}
 
@@ -120,50 +57,22 @@ bool TrainingControllerEpisodic::onActionRequired(AGENT_ID agentID, std::vector<
 		return false;	// Not allowed in this step. 
 	}
 
-	// Get agent. 
-	Agent* agent = getAgents()[agentID];
-
-#if defined(_DEBUG) and defined(MEASURE_TIME)
-	auto start = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-#endif
-
-	// Get or create state data. 
-	const StateData* stateData = TrainingController::getOrCreateStateData(agentID);
+	// Run policy of this agent only. 
+	std::vector<std::vector<torch::Tensor>> outputs = std::vector<std::vector<torch::Tensor>>(1);
+	runPolicies({ agentID }, outputs);
+	output.insert(output.end(), outputs[0].begin(), outputs[0].end());
 
-	// Save input tensor (state tensor). 
-	agent->states.push_back(stateData->inputTensor);
-
-	// Pass inputs into model to produce actor and critic outputs. 
-	std::tuple<torch::Tensor, torch::Tensor> outputTuple = agent->model->get()->forward(stateData->inputTensorDevice, true);
-
-#if defined(_DEBUG) and defined(MEASURE_TIME)
-	auto finish = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-	auto total = finish - start;
-	std::cout << "[" + std::to_string(agentID) + "] ran from " + std::to_string(start) + " to " + std::to_string(finish) + "(total of " + std::to_string(total) + ")" << std::endl;
-#endif
-
-	// Extract actual output (vector index, sequence, batch). 
-	torch::Tensor actorOutput = std::get<0>(outputTuple)[0];
-	torch::Tensor criticOutput = std::get<1>(outputTuple)[0];
-
-	// Save action returned by the actor (just the action type at index 0). 
-	agent->actions.push_back(torch::full(1, actorOutput[0].item()));
-
-	// Create and save logProb. 
-	torch::Tensor logProb = agent->model->get()->logProb(actorOutput[0]);
-	agent->logProbs.push_back(logProb);
-
-	// Save value returned by the critic. 
-	agent->values.push_back(criticOutput);
-
-	// Copy output tensor to CPU for faster access while decoding. 
-	actorOutput = actorOutput.to(torch::kCPU);
+	return true;
+}
 
-	// Fill output vector. 
-	output.push_back(actorOutput);
-	output.push_back(criticOutput);
+void TrainingControllerEpisodic::onActionsRequired(std::vector<std::vector<torch::Tensor>>& outputs) {
+	// Check wether action is allowed (policy step). All agents act in the same steps. 
+	if(stepsTillAction != 0) {
+		return;	// Not allowed in this step. 
+	}
 
-	return true;
+	// Run the policies of all agents batched. 
+	runPolicies(getAgentIDs(), outputs);
 }
 
 void TrainingControllerEpisodic::onAgentExecuted(AGENT_ID agentID) {// Determine reward via rewarder. 
@@ -171,9 +80,23 @@ void TrainingControllerEpisodic::onAgentExecuted(AGENT_ID agentID) {// Determine
 
 	// Add reward to agent. 
 	Agent* agent = getAgents()[agentID];
-	agent->rewards.push_back(reward);
-	agent->totalReward += reward;
-	agent->rewardsCount++;
+	agent->rollout->rewards.push_back(reward);
+	agent->rollout->totalReward += reward;
+	agent->rollout->rewardsCount++;
+	agent->episodeReward += reward;
+	agent->episodeSteps++;
+}
+
+bool TrainingControllerEpisodic::onAgentEpisodeEnded(AGENT_ID agentID) {
+	// Only this agents episode ended, it counts as an episode of its own. 
+	setTrainedEpisodes(getTrainedEpisodes() + 1);
+
+	finishAgentEpisode(getAgents()[agentID]);
+
+	onEpisodesFinished(1);
+
+	// Check if episode limit reached. If so, terminate training. 
+	return maxEpisodesReached();
 }
 
 bool TrainingControllerEpisodic::onGameTickPassed() {
@@ -196,6 +119,11 @@ bool TrainingControllerEpisodic::onGameTickPassed() {
 	return false;	// False = no need to terminate episode. 
 }
 
+uint32_t TrainingControllerEpisodic::getRolloutCapacity() const {
+	uint64_t stepsPerEpisode = getTrainingParameters()->maxEpisodeLength / Maths::max<uint32_t>(getTrainingParameters()->policyStepLength, 1);
+	return static_cast<uint32_t>(Maths::min<uint64_t>(stepsPerEpisode * getTrainingParameters()->trainingStepLength, UINT32_MAX));
+}
+
 bool TrainingControllerEpisodic::initInternal() {
 	setTrainedEpisodes(0);
 
@@ -203,11 +131,6 @@ bool TrainingControllerEpisodic::initInternal() {
 	setVerbose(true);
 #endif
 
-	// Pre-fill state datas. 
-	for(uint32_t i = 0; i < NUM_OF_AGENTS; i++) {
-		getStateDatas().push_back(std::vector<StateData*>());
-	}
-
 	initAgents(NUM_OF_AGENTS);
 
 	setStepsInThisEpisode(-1);
@@ -228,13 +151,91 @@ void TrainingControllerEpisodic::cleanUpInternal() {
 }
 
 void TrainingControllerEpisodic::resetAgentTrainingStep(Agent* agent) {
-	agent->states.clear();
-	agent->actions.clear();
-	agent->values.clear();
-	agent->logProbs.clear();
-	agent->rewards.clear();
-	agent->totalReward = 0.0;
-	agent->rewardsCount = 0;
+	agent->rollout->clear();
+	agent->episodeStartIndex = 0;	// A running episode continues in the next training step. 
+}
+
+void TrainingControllerEpisodic::finishAgentEpisode(Agent* agent) {
+	double episodeReward = agent->episodeReward;
+
+	// If agents ID is 0, post average of last 100 episode rewards. 
+	if(agent->agentID == 0) {
+		lastEpisodeRewards.add(episodeReward);
+		if(lastEpisodeRewards.size() > 100) {
+			// Remove oldest value. 
+			lastEpisodeRewards.removeIndex(0);
+			// Calculate average. 
+			double average = calculateAverage(lastEpisodeRewards);
+			// Post average. 
+			HTTPHelper::postRewardAverage(average);
+		}
+	}
+
+	// Log episode rewards. 
+	TrainingLogger::onAgentRewarded(agent->agentID, episodeReward);
+
+	// If the environment only gives a reward at the end, modify reward values. 
+	if(getEnvironment()->onlyFinalReward() && episodeReward > 0.0) {
+		// Set reward for all steps in this episode to the episode reward. The range is tracked per agent, as the ticks of the scenario don't match the rewarded steps of an agent (policyStepLength, VectorEnvironment). 
+		for(uint32_t i = agent->episodeStartIndex; i < agent->rollout->rewardsCount; i++) {
+			agent->rollout->rewards[i] = episodeReward;
+		}
+	}
+
+	// Start next episode. 
+	agent->episodeStartIndex = agent->rollout->rewardsCount;
+	agent->episodeReward = 0.0;
+	agent->episodeSteps = 0;
+}
+
+void TrainingControllerEpisodic::onEpisodesFinished(uint32_t numOfEpisodes) {
+	if(numOfEpisodes == 0) {
+		return;
+	}
+	episodesTillOptimization -= Maths::min<uint32_t>(numOfEpisodes, episodesTillOptimization);
+	// Check whether its time for an optimization step. 
+	if(episodesTillOptimization == 0) {
+		// Optimization step. 
+		// Log total rewards of the finished training step. 
+		for(Agent* agent : getAgents()) {
+			TrainingLogger::onAgentTrained(agent->agentID, agent->rollout->totalReward);
+		}
+
+		// Optimize agents. Either done here or handed to the learner thread (see TrainingParameters::asyncLearner). 
+		optimizeAgents(getAgents());
+
+		// Update VM episode count. 
+		TrainingController::updateVMEpisodeCount(getTrainedEpisodes());
+
+		// Reset agents. 
+		for(Agent* agent : getAgents()) {
+			resetAgentTrainingStep(agent);
+		}
+
+		// Clean up state datas. 
+		TrainingController::cleanUpStateDatas();
+
+		// Reset optimization counter. 
+		episodesTillOptimization = getTrainingParameters()->trainingStepLength;
+	}
+
+	// Check if a checkpoint should be created. 
+	if(episodesTillCheckpoint != UINT32_MAX) {
+		episodesTillCheckpoint -= Maths::min<uint32_t>(numOfEpisodes, episodesTillCheckpoint);
+	}
+	if(episodesTillCheckpoint == 0) {
+		// Save agents as episode ended. 
+		std::string checkpointFilePath;
+		saveAgents(getTrainedEpisodes(), checkpointFilePath);
+		// Log. 
+		TrainingLogger::onCheckpointCreated(checkpointFilePath, getTrainedEpisodes());
+
+		episodesTillCheckpoint = getTrainingParameters()->episodesPerCheckpoint;
+	}
+}
+
+bool TrainingControllerEpisodic::maxEpisodesReached() const {
+	return getTrainedEpisodes() >= getTrainingParameters()->maxEpisodes && getTrainingParameters()->maxEpisodes > 0;
 }
 
 double TrainingControllerEpisodic::calculateAverage(const ArrayList<double>& values) const {
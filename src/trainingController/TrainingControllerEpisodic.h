@@ -13,9 +13,16 @@ namespace PLANS {
 
 			virtual bool onActionRequired(AGENT_ID agentID, std::vector<torch::Tensor>& output) final override;
 
+			virtual void onActionsRequired(std::vector<std::vector<torch::Tensor>>& outputs) final override;
+
 			virtual void onAgentExecuted(AGENT_ID agentID) final override;
 
+			virtual bool onAgentEpisodeEnded(AGENT_ID agentID) final override;
+
 			virtual bool onGameTickPassed() final override;
+
+			// "trainingStepLength" counts episodes here, each one has up to maxEpisodeLength / policyStepLength steps. 
+			virtual uint32_t getRolloutCapacity() const final override;
 		protected:
 			virtual bool initInternal() final override;
 			virtual void cleanUpInternal() final override;
@@ -27,6 +34,11 @@ namespace PLANS {
 
 			// Called after every optimizer step to reset the rewards and values of the agents. 
 			void resetAgentTrainingStep(Agent* agent);
+			// Logs the episode reward of the given agent and starts its next episode. 
+			void finishAgentEpisode(Agent* agent);
+			// Called after "trainedEpisodes" has been increased by the given number of agent episodes. Runs the optimization and checkpoint schedules. 
+			void onEpisodesFinished(uint32_t numOfEpisodes);
+			bool maxEpisodesReached() const;
 			double calculateAverage(const AEX::ArrayList<double>& values) const;
 	};
 
@@ -3,6 +3,7 @@
 
 #include "StringUtils.h"
 #include "compression/GZip.h"
+#include "compression/BlockCompression.h"
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -133,6 +134,62 @@ void IOUtils::writeCompressedBytesToFile(const std::string& filename, bool recre
 	delete[] outputData;
 }
 
+int8_t* IOUtils::readBlockCompressedBytesFromFile(const std::string& filename, uint64_t& dataSize, uint32_t numOfThreads) {
+	uint64_t inputSize;
+	int8_t* inputData = readBytesFromFile(filename, inputSize);
+	int8_t* outputData;
+	try {
+		if(BlockDecompressor::isBlockCompressed(inputData, inputSize)) {
+			BlockDecompressor decompressor = BlockDecompressor(numOfThreads);
+			outputData = decompressor.decompress(inputData, inputSize, dataSize);
+		} else {
+			GZipDecompressor decompressor;
+			outputData = decompressor.decompress(inputData, inputSize, dataSize);
+		}
+	} catch(...) {
+		delete[] inputData;
+		throw;
+	}
+	delete[] inputData;
+	return outputData;
+}
+
+bool IOUtils::isBlockCompressedFile(const std::string& filename) {
+	//Only header and footer are read
+	std::filesystem::path fileLocation = std::filesystem::u8path(filename);
+	if(!std::filesystem::exists(fileLocation) || !std::filesystem::is_regular_file(fileLocation)) {
+		throw io_error("File not found! Filename: " + filename);
+	}
+	uint64_t fileSize = static_cast<uint64_t>(std::filesystem::file_size(fileLocation));
+	if(fileSize < BLOCK_COMPRESSION_HEADER_SIZE + BLOCK_COMPRESSION_FOOTER_SIZE) {
+		return false;
+	}
+	std::ifstream stream;
+	stream.open(fileLocation, std::ios::binary | std::ios::in);
+	if(!stream) {
+		throw io_error("Failed to open the stream! Filename: " + filename);
+	}
+	int8_t data[BLOCK_COMPRESSION_HEADER_SIZE + BLOCK_COMPRESSION_FOOTER_SIZE];
+	stream.read(reinterpret_cast<char*>(data), BLOCK_COMPRESSION_HEADER_SIZE);
+	stream.seekg(fileSize - BLOCK_COMPRESSION_FOOTER_SIZE);
+	stream.read(reinterpret_cast<char*>(&data[BLOCK_COMPRESSION_HEADER_SIZE]), BLOCK_COMPRESSION_FOOTER_SIZE);
+	stream.close();
+	return BlockDecompressor::isBlockCompressed(data, BLOCK_COMPRESSION_HEADER_SIZE + BLOCK_COMPRESSION_FOOTER_SIZE);
+}
+
+void IOUtils::writeBlockCompressedBytesToFile(const std::string& filename, bool recreate, int8_t* data, uint64_t dataSize, uint32_t level, uint32_t numOfThreads) {
+	uint64_t outputSize;
+	BlockCompressor compressor = BlockCompressor(level, numOfThreads);
+	int8_t* outputData = compressor.compress(data, dataSize, outputSize);
+	try {
+		writeBytesToFile(filename, recreate, outputData, outputSize);
+	} catch(...) {
+		delete[] outputData;
+		throw;
+	}
+	delete[] outputData;
+}
+
 std::string IOUtils::readStringFromFile(const std::string& filename) {
 	std::filesystem::path fileLocation = std::filesystem::u8path(filename);
 	if(!std::filesystem::exists(fileLocation)) {
@@ -53,6 +53,11 @@ namespace AEX {
 			static void writeBytesToFile(const std::string& filename, bool recreate, int8_t* data, uint64_t dataSize);
 			static int8_t* readCompressedBytesFromFile(const std::string& filename, uint64_t& dataSize);
 			static void writeCompressedBytesToFile(const std::string& filename, bool recreate, int8_t* data, uint64_t dataSize);
+			//Falls back to gzip if the file is not block compressed. 0 threads uses one thread per hardware thread
+			static int8_t* readBlockCompressedBytesFromFile(const std::string& filename, uint64_t& dataSize, uint32_t numOfThreads = 0);
+			static bool isBlockCompressedFile(const std::string& filename);
+			//Level 0 stores the blocks uncompressed, see BlockCompressor
+			static void writeBlockCompressedBytesToFile(const std::string& filename, bool recreate, int8_t* data, uint64_t dataSize, uint32_t level, uint32_t numOfThreads = 0);
 			static std::string readStringFromFile(const std::string& filename);
 			static void writeStringToFile(const std::string& filename, bool recreate, const std::string& data);
 			static void readFile(const std::string& filename, ArrayList<std::string>& data);
@@ -0,0 +1,102 @@
+#include "MappedFile.h"
+
+#include "IOUtils.h"
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace AEX;
+
+//############################ MappedFile ############################
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) : data(nullptr), dataSize(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {
+	std::filesystem::path fileLocation = std::filesystem::u8path(filename);
+	fileHandle = CreateFileW(fileLocation.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(fileHandle == INVALID_HANDLE_VALUE) {
+		throw io_error("Failed to open the file! Filename: " + filename);
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(fileHandle, &fileSize)) {
+		CloseHandle(fileHandle);
+		throw io_error("Failed to determine the file size! Filename: " + filename);
+	}
+	dataSize = static_cast<uint64_t>(fileSize.QuadPart);
+	if(dataSize == 0) {
+		return;	//Empty files can't be mapped
+	}
+	mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if(mappingHandle == nullptr) {
+		CloseHandle(fileHandle);
+		throw io_error("Failed to map the file! Filename: " + filename);
+	}
+	data = static_cast<int8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0));
+	if(data == nullptr) {
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		throw io_error("Failed to map the file! Filename: " + filename);
+	}
+}
+
+MappedFile::~MappedFile() {
+	if(data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if(mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+	}
+	if(fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+	}
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) : data(nullptr), dataSize(0) {
+	int fileDescriptor = open(filename.c_str(), O_RDONLY);
+	if(fileDescriptor < 0) {
+		throw io_error("Failed to open the file! Filename: " + filename);
+	}
+	struct stat fileStatus;
+	if(fstat(fileDescriptor, &fileStatus) != 0) {
+		close(fileDescriptor);
+		throw io_error("Failed to determine the file size! Filename: " + filename);
+	}
+	dataSize = static_cast<uint64_t>(fileStatus.st_size);
+	if(dataSize == 0) {
+		close(fileDescriptor);
+		return;	//Empty files can't be mapped
+	}
+	void* mapping = mmap(nullptr, dataSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);	//The mapping stays valid
+	if(mapping == MAP_FAILED) {
+		throw io_error("Failed to map the file! Filename: " + filename);
+	}
+	data = static_cast<int8_t*>(mapping);
+}
+
+MappedFile::~MappedFile() {
+	if(data != nullptr) {
+		munmap(data, dataSize);
+	}
+}
+
+#endif
+
+int8_t* MappedFile::getData() const {
+	return data;
+}
+
+uint64_t MappedFile::getDataSize() const {
+	return dataSize;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace AEX {
+
+	//Maps a whole file into memory copy-on-write: the pages are loaded on first access, modifications stay private to the process and are never written back
+	class MappedFile {
+		private:
+			int8_t* data;
+			uint64_t dataSize;
+#ifdef _WIN32
+			void* fileHandle;
+			void* mappingHandle;
+#endif
+		protected:
+		public:
+			explicit MappedFile(const std::string& filename);
+			~MappedFile();
+			int8_t* getData() const;
+			uint64_t getDataSize() const;
+
+			MappedFile(const MappedFile& mappedFile) = delete;
+			MappedFile& operator=(const MappedFile& mappedFile) = delete;
+	};
+}
@@ -0,0 +1,331 @@
+#include "Preprocessing.h"
+
+#include <climits>
+
+using namespace AEX;
+
+//Fixed point luminance weights (of 256)
+static const uint32_t GRAY_WEIGHT_R = 77;
+static const uint32_t GRAY_WEIGHT_G = 150;
+static const uint32_t GRAY_WEIGHT_B = 29;
+
+//############################ Level ############################
+
+static SIMDLevel& getCurrentLevel() {
+	static SIMDLevel currentLevel = SIMD::getDetectedLevel();
+	return currentLevel;
+}
+
+//############################ Scalar ############################
+
+static void convertScalar(const uint8_t* input, float* output, size_t count, float scale, float offset) {
+	for(size_t i = 0;i < count;i++) {
+		output[i] = static_cast<float>(input[i]) * scale + offset;
+	}
+}
+
+static void gatherScalar(const uint8_t* input, const uint32_t* indices, float* output, size_t count, float scale, float offset) {
+	for(size_t i = 0;i < count;i++) {
+		output[i] = static_cast<float>(input[indices[i]]) * scale + offset;
+	}
+}
+
+static void grayscaleScalar(const uint8_t* rgb, uint8_t* output, size_t numOfPixels) {
+	for(size_t i = 0;i < numOfPixels;i++) {
+		const uint8_t* pixel = rgb + i * 3;
+		output[i] = static_cast<uint8_t>((GRAY_WEIGHT_R * pixel[0] + GRAY_WEIGHT_G * pixel[1] + GRAY_WEIGHT_B * pixel[2] + 128) >> 8);
+	}
+}
+
+//Downsamples the output columns [firstColumn, outputWidth) of one output row
+static void downsampleRowScalar(const uint8_t* top, const uint8_t* bottom, float* output, uint32_t firstColumn, uint32_t outputWidth, float quarterScale, float offset) {
+	for(uint32_t x = firstColumn;x < outputWidth;x++) {
+		uint32_t sum = top[x * 2] + top[x * 2 + 1] + bottom[x * 2] + bottom[x * 2 + 1];
+		output[x] = static_cast<float>(sum) * quarterScale + offset;
+	}
+}
+
+static void maxPoolScalar(const uint8_t* a, const uint8_t* b, uint8_t* output, size_t count) {
+	for(size_t i = 0;i < count;i++) {
+		output[i] = a[i] > b[i] ? a[i] : b[i];
+	}
+}
+
+#ifdef AEX_SIMD_X86
+
+//############################ SSE ############################
+
+AEX_TARGET_SSE static inline void storeSSE(float* output, __m128i values, __m128 scale, __m128 offset) {
+	_mm_storeu_ps(output, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(values), scale), offset));
+}
+
+AEX_TARGET_SSE static void convertSSE(const uint8_t* input, float* output, size_t count, float scale, float offset) {
+	__m128 scaleVector = _mm_set1_ps(scale);
+	__m128 offsetVector = _mm_set1_ps(offset);
+	size_t i = 0;
+	for(;i + 16 <= count;i += 16) {
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+		storeSSE(output + i, _mm_cvtepu8_epi32(bytes), scaleVector, offsetVector);
+		storeSSE(output + i + 4, _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4)), scaleVector, offsetVector);
+		storeSSE(output + i + 8, _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 8)), scaleVector, offsetVector);
+		storeSSE(output + i + 12, _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 12)), scaleVector, offsetVector);
+	}
+	convertScalar(input + i, output + i, count - i, scale, offset);
+}
+
+//SSE has no gather, the bytes are loaded one by one and converted together
+AEX_TARGET_SSE static void gatherSSE(const uint8_t* input, const uint32_t* indices, float* output, size_t count, float scale, float offset) {
+	__m128 scaleVector = _mm_set1_ps(scale);
+	__m128 offsetVector = _mm_set1_ps(offset);
+	size_t i = 0;
+	for(;i + 4 <= count;i += 4) {
+		__m128i values = _mm_setr_epi32(input[indices[i]], input[indices[i + 1]], input[indices[i + 2]], input[indices[i + 3]]);
+		storeSSE(output + i, values, scaleVector, offsetVector);
+	}
+	gatherScalar(input, indices + i, output + i, count - i, scale, offset);
+}
+
+//Widens 16 bytes to 16 bit, weights them and adds them to the accumulators
+AEX_TARGET_SSE static inline void accumulateChannelSSE(__m128i channel, __m128i weight, __m128i& low, __m128i& high) {
+	__m128i zero = _mm_setzero_si128();
+	low = _mm_add_epi16(low, _mm_mullo_epi16(_mm_unpacklo_epi8(channel, zero), weight));
+	high = _mm_add_epi16(high, _mm_mullo_epi16(_mm_unpackhi_epi8(channel, zero), weight));
+}
+
+//Deinterleaves 16 pixels (48 bytes) per iteration via byte shuffles. The sums fit into unsigned 16 bit, as the weights add up to 256
+AEX_TARGET_SSE static void grayscaleSSE(const uint8_t* rgb, uint8_t* output, size_t numOfPixels) {
+	const __m128i shuffleR0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i shuffleR1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+	const __m128i shuffleR2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+	const __m128i shuffleG0 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i shuffleG1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+	const __m128i shuffleG2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+	const __m128i shuffleB0 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i shuffleB1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+	const __m128i shuffleB2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+	const __m128i weightR = _mm_set1_epi16(GRAY_WEIGHT_R);
+	const __m128i weightG = _mm_set1_epi16(GRAY_WEIGHT_G);
+	const __m128i weightB = _mm_set1_epi16(GRAY_WEIGHT_B);
+	const __m128i rounding = _mm_set1_epi16(128);
+	size_t i = 0;
+	for(;i + 16 <= numOfPixels;i += 16) {
+		const __m128i* source = reinterpret_cast<const __m128i*>(rgb + i * 3);
+		__m128i part0 = _mm_loadu_si128(source);
+		__m128i part1 = _mm_loadu_si128(source + 1);
+		__m128i part2 = _mm_loadu_si128(source + 2);
+		__m128i r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(part0, shuffleR0), _mm_shuffle_epi8(part1, shuffleR1)), _mm_shuffle_epi8(part2, shuffleR2));
+		__m128i g = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(part0, shuffleG0), _mm_shuffle_epi8(part1, shuffleG1)), _mm_shuffle_epi8(part2, shuffleG2));
+		__m128i b = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(part0, shuffleB0), _mm_shuffle_epi8(part1, shuffleB1)), _mm_shuffle_epi8(part2, shuffleB2));
+		__m128i low = rounding;
+		__m128i high = rounding;
+		accumulateChannelSSE(r, weightR, low, high);
+		accumulateChannelSSE(g, weightG, low, high);
+		accumulateChannelSSE(b, weightB, low, high);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8)));
+	}
+	grayscaleScalar(rgb + i * 3, output + i, numOfPixels - i);
+}
+
+AEX_TARGET_SSE static void downsampleSSE(const uint8_t* input, uint32_t width, uint32_t height, float* output, float scale, float offset) {
+	uint32_t outputWidth = width / 2;
+	float quarterScale = scale * 0.25F;
+	__m128 scaleVector = _mm_set1_ps(quarterScale);
+	__m128 offsetVector = _mm_set1_ps(offset);
+	__m128i ones = _mm_set1_epi8(1);
+	for(uint32_t y = 0;y < height / 2;y++) {
+		const uint8_t* top = input + static_cast<size_t>(y * 2) * width;
+		const uint8_t* bottom = top + width;
+		float* outputRow = output + static_cast<size_t>(y) * outputWidth;
+		uint32_t x = 0;
+		for(;x + 8 <= outputWidth;x += 8) {
+			//Sums of horizontally adjacent pixels of both rows (at most 4 * 255)
+			__m128i topSums = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(top + x * 2)), ones);
+			__m128i bottomSums = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + x * 2)), ones);
+			__m128i sums = _mm_add_epi16(topSums, bottomSums);
+			storeSSE(outputRow + x, _mm_cvtepu16_epi32(sums), scaleVector, offsetVector);
+			storeSSE(outputRow + x + 4, _mm_cvtepu16_epi32(_mm_srli_si128(sums, 8)), scaleVector, offsetVector);
+		}
+		downsampleRowScalar(top, bottom, outputRow, x, outputWidth, quarterScale, offset);
+	}
+}
+
+AEX_TARGET_SSE static void maxPoolSSE(const uint8_t* a, const uint8_t* b, uint8_t* output, size_t count) {
+	size_t i = 0;
+	for(;i + 16 <= count;i += 16) {
+		__m128i valuesA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+		__m128i valuesB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_max_epu8(valuesA, valuesB));
+	}
+	maxPoolScalar(a + i, b + i, output + i, count - i);
+}
+
+//############################ AVX2 ############################
+
+AEX_TARGET_AVX2 static inline void storeAVX2(float* output, __m256i values, __m256 scale, __m256 offset) {
+	_mm256_storeu_ps(output, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(values), scale), offset));
+}
+
+AEX_TARGET_AVX2 static void convertAVX2(const uint8_t* input, float* output, size_t count, float scale, float offset) {
+	__m256 scaleVector = _mm256_set1_ps(scale);
+	__m256 offsetVector = _mm256_set1_ps(offset);
+	size_t i = 0;
+	for(;i + 32 <= count;i += 32) {
+		__m128i bytes0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+		__m128i bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 16));
+		storeAVX2(output + i, _mm256_cvtepu8_epi32(bytes0), scaleVector, offsetVector);
+		storeAVX2(output + i + 8, _mm256_cvtepu8_epi32(_mm_srli_si128(bytes0, 8)), scaleVector, offsetVector);
+		storeAVX2(output + i + 16, _mm256_cvtepu8_epi32(bytes1), scaleVector, offsetVector);
+		storeAVX2(output + i + 24, _mm256_cvtepu8_epi32(_mm_srli_si128(bytes1, 8)), scaleVector, offsetVector);
+	}
+	for(;i + 8 <= count;i += 8) {
+		storeAVX2(output + i, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + i))), scaleVector, offsetVector);
+	}
+	convertScalar(input + i, output + i, count - i, scale, offset);
+}
+
+//Gathers 32 bit per index and masks the lowest byte. Blocks with an index in the last 3 bytes of the input are gathered scalar, to not read past its end
+AEX_TARGET_AVX2 static void gatherAVX2(const uint8_t* input, size_t inputSize, const uint32_t* indices, float* output, size_t count, float scale, float offset) {
+	if(inputSize < 4 || inputSize > INT_MAX) {
+		gatherScalar(input, indices, output, count, scale, offset);
+		return;
+	}
+	__m256 scaleVector = _mm256_set1_ps(scale);
+	__m256 offsetVector = _mm256_set1_ps(offset);
+	__m256i lastSafeIndex = _mm256_set1_epi32(static_cast<int>(inputSize - 4));
+	__m256i byteMask = _mm256_set1_epi32(0xFF);
+	size_t i = 0;
+	for(;i + 8 <= count;i += 8) {
+		__m256i indexVector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+		if(_mm256_movemask_epi8(_mm256_cmpgt_epi32(indexVector, lastSafeIndex)) != 0) {
+			gatherScalar(input, indices + i, output + i, 8, scale, offset);
+			continue;
+		}
+		__m256i values = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(input), indexVector, 1), byteMask);
+		storeAVX2(output + i, values, scaleVector, offsetVector);
+	}
+	gatherScalar(input, indices + i, output + i, count - i, scale, offset);
+}
+
+AEX_TARGET_AVX2 static void downsampleAVX2(const uint8_t* input, uint32_t width, uint32_t height, float* output, float scale, float offset) {
+	uint32_t outputWidth = width / 2;
+	float quarterScale = scale * 0.25F;
+	__m256 scaleVector = _mm256_set1_ps(quarterScale);
+	__m256 offsetVector = _mm256_set1_ps(offset);
+	__m256i ones = _mm256_set1_epi8(1);
+	for(uint32_t y = 0;y < height / 2;y++) {
+		const uint8_t* top = input + static_cast<size_t>(y * 2) * width;
+		const uint8_t* bottom = top + width;
+		float* outputRow = output + static_cast<size_t>(y) * outputWidth;
+		uint32_t x = 0;
+		for(;x + 16 <= outputWidth;x += 16) {
+			//The pair sums stay in order, as pairs never cross the 128 bit lanes
+			__m256i topSums = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + x * 2)), ones);
+			__m256i bottomSums = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + x * 2)), ones);
+			__m256i sums = _mm256_add_epi16(topSums, bottomSums);
+			storeAVX2(outputRow + x, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(sums)), scaleVector, offsetVector);
+			storeAVX2(outputRow + x + 8, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(sums, 1)), scaleVector, offsetVector);
+		}
+		downsampleRowScalar(top, bottom, outputRow, x, outputWidth, quarterScale, offset);
+	}
+}
+
+AEX_TARGET_AVX2 static void maxPoolAVX2(const uint8_t* a, const uint8_t* b, uint8_t* output, size_t count) {
+	size_t i = 0;
+	for(;i + 32 <= count;i += 32) {
+		__m256i valuesA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+		__m256i valuesB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_max_epu8(valuesA, valuesB));
+	}
+	maxPoolScalar(a + i, b + i, output + i, count - i);
+}
+
+#endif
+
+//############################ Preprocessing ############################
+
+SIMDLevel Preprocessing::getLevel() {
+	return getCurrentLevel();
+}
+
+void Preprocessing::setLevel(SIMDLevel level) {
+	getCurrentLevel() = level < SIMD::getDetectedLevel() ? level : SIMD::getDetectedLevel();
+}
+
+void Preprocessing::convert(const uint8_t* input, float* output, size_t count, float scale, float offset) {
+#ifdef AEX_SIMD_X86
+	switch(getCurrentLevel()) {
+		case SIMDLevel::AVX2:
+			convertAVX2(input, output, count, scale, offset);
+			return;
+		case SIMDLevel::SSE:
+			convertSSE(input, output, count, scale, offset);
+			return;
+		default:
+			break;
+	}
+#endif
+	convertScalar(input, output, count, scale, offset);
+}
+
+void Preprocessing::gather(const uint8_t* input, size_t inputSize, const uint32_t* indices, float* output, size_t count, float scale, float offset) {
+#ifdef AEX_SIMD_X86
+	switch(getCurrentLevel()) {
+		case SIMDLevel::AVX2:
+			gatherAVX2(input, inputSize, indices, output, count, scale, offset);
+			return;
+		case SIMDLevel::SSE:
+			gatherSSE(input, indices, output, count, scale, offset);
+			return;
+		default:
+			break;
+	}
+#endif
+	gatherScalar(input, indices, output, count, scale, offset);
+}
+
+void Preprocessing::grayscale(const uint8_t* rgb, uint8_t* output, size_t numOfPixels) {
+#ifdef AEX_SIMD_X86
+	//The byte shuffles only work within 128 bit lanes, so AVX2 uses the SSE path as well
+	if(getCurrentLevel() >= SIMDLevel::SSE) {
+		grayscaleSSE(rgb, output, numOfPixels);
+		return;
+	}
+#endif
+	grayscaleScalar(rgb, output, numOfPixels);
+}
+
+void Preprocessing::downsample(const uint8_t* input, uint32_t width, uint32_t height, float* output, float scale, float offset) {
+#ifdef AEX_SIMD_X86
+	switch(getCurrentLevel()) {
+		case SIMDLevel::AVX2:
+			downsampleAVX2(input, width, height, output, scale, offset);
+			return;
+		case SIMDLevel::SSE:
+			downsampleSSE(input, width, height, output, scale, offset);
+			return;
+		default:
+			break;
+	}
+#endif
+	uint32_t outputWidth = width / 2;
+	for(uint32_t y = 0;y < height / 2;y++) {
+		const uint8_t* top = input + static_cast<size_t>(y * 2) * width;
+		downsampleRowScalar(top, top + width, output + static_cast<size_t>(y) * outputWidth, 0, outputWidth, scale * 0.25F, offset);
+	}
+}
+
+void Preprocessing::maxPool(const uint8_t* a, const uint8_t* b, uint8_t* output, size_t count) {
+#ifdef AEX_SIMD_X86
+	switch(getCurrentLevel()) {
+		case SIMDLevel::AVX2:
+			maxPoolAVX2(a, b, output, count);
+			return;
+		case SIMDLevel::SSE:
+			maxPoolSSE(a, b, output, count);
+			return;
+		default:
+			break;
+	}
+#endif
+	maxPoolScalar(a, b, output, count);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "SIMD.h"
+
+namespace AEX {
+
+	//Kernels which turn raw observations (RAM bytes, screen pixels) into network input
+	//Every kernel has an AVX2, an SSE and a scalar path with identical results. The best level supported by the CPU is detected at the first call
+	//The kernels write into the given buffers directly and never allocate. Input and output must not overlap
+	class Preprocessing {
+		private:
+		protected:
+		public:
+			static SIMDLevel getLevel();
+			//Restricts the kernels to the given level, e.g. to compare the paths. Levels above the detected one are lowered to it. Not thread-safe, call it before preprocessing
+			static void setLevel(SIMDLevel level);
+
+			//output[i] = input[i] * scale + offset
+			static void convert(const uint8_t* input, float* output, size_t count, float scale = 1.0F, float offset = 0.0F);
+			//output[i] = input[indices[i]] * scale + offset. All indices must be smaller than inputSize
+			static void gather(const uint8_t* input, size_t inputSize, const uint32_t* indices, float* output, size_t count, float scale = 1.0F, float offset = 0.0F);
+			//Luminance of interleaved RGB pixels, weighted 77 / 150 / 29 (of 256)
+			static void grayscale(const uint8_t* rgb, uint8_t* output, size_t numOfPixels);
+			//Averages the 2x2 blocks of a width x height image into (width / 2) x (height / 2) values, scaled and offset like in "convert". An odd last row / column is dropped
+			static void downsample(const uint8_t* input, uint32_t width, uint32_t height, float* output, float scale = 1.0F, float offset = 0.0F);
+			//output[i] = max(a[i], b[i]), e.g. to remove the flicker of two consecutive frames
+			static void maxPool(const uint8_t* a, const uint8_t* b, uint8_t* output, size_t count);
+	};
+}
@@ -0,0 +1,94 @@
+#include "SIMD.h"
+
+#if defined(AEX_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace AEX;
+
+//############################ Detection ############################
+
+static SIMDLevel detectLevel() {
+#ifdef AEX_SIMD_X86
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	__cpuid(info, 1);
+	bool sse = (info[2] & (1 << 19)) != 0;
+	//AVX2 also requires the OS to save the YMM registers
+	bool avx2 = false;
+	if(maxLeaf >= 7 && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	bool sse = __builtin_cpu_supports("sse4.1");
+	bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+	if(avx2 && sse) {
+		return SIMDLevel::AVX2;
+	}
+	if(sse) {
+		return SIMDLevel::SSE;
+	}
+#endif
+	return SIMDLevel::SCALAR;
+}
+
+//############################ Dot ############################
+
+static float dotScalar(const float* a, const float* b, uint32_t length) {
+	float sum = 0.0F;
+	for(uint32_t i = 0;i < length;i++) {
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+#ifdef AEX_SIMD_X86
+
+AEX_TARGET_SSE static float dotSSE(const float* a, const float* b, uint32_t length) {
+	__m128 sum = _mm_setzero_ps();
+	for(uint32_t i = 0;i < length;i += 4) {
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+	}
+	sum = _mm_hadd_ps(sum, sum);
+	sum = _mm_hadd_ps(sum, sum);
+	return _mm_cvtss_f32(sum);
+}
+
+AEX_TARGET_AVX2 static float dotAVX2(const float* a, const float* b, uint32_t length) {
+	__m256 sum = _mm256_setzero_ps();
+	for(uint32_t i = 0;i < length;i += 8) {
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+	}
+	__m128 halfSum = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+	halfSum = _mm_hadd_ps(halfSum, halfSum);
+	halfSum = _mm_hadd_ps(halfSum, halfSum);
+	return _mm_cvtss_f32(halfSum);
+}
+
+#endif
+
+//############################ SIMD ############################
+
+SIMDLevel SIMD::getDetectedLevel() {
+	static const SIMDLevel detectedLevel = detectLevel();
+	return detectedLevel;
+}
+
+float SIMD::dot(SIMDLevel level, const float* a, const float* b, uint32_t length) {
+#ifdef AEX_SIMD_X86
+	switch(level) {
+		case SIMDLevel::AVX2:
+			return dotAVX2(a, b, length);
+		case SIMDLevel::SSE:
+			return dotSSE(a, b, length);
+		default:
+			break;
+	}
+#endif
+	return dotScalar(a, b, length);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AEX_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+//MSVC allows all intrinsics without flags
+#define AEX_TARGET_SSE
+#define AEX_TARGET_AVX2
+#else
+//Only functions marked with these are compiled for the extended instruction sets, they may only be called after checking SIMD::getDetectedLevel
+#define AEX_TARGET_SSE __attribute__((target("sse4.1")))
+#define AEX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace AEX {
+
+	//Instruction set used by vectorized kernels
+	enum class SIMDLevel : uint8_t {
+		SCALAR = 0,
+		SSE = 1,	//SSE4.1 (includes SSSE3)
+		AVX2 = 2
+	};
+
+	class SIMD {
+		private:
+		protected:
+		public:
+			//Best level supported by the CPU and the OS. Detected once at the first call
+			static SIMDLevel getDetectedLevel();
+			//Dot product of two float arrays with the kernel of the given level, which may not exceed the detected one. "length" has to be a multiple of 8
+			static float dot(SIMDLevel level, const float* a, const float* b, uint32_t length);
+	};
+}
@@ -1,6 +1,9 @@
 // Author: https://github.com/AMXerSurf
 #include "Serialization.h"
 
+#include <cstring>
+#include <algorithm>
+
 using namespace AEX;
 
 //############################ serialization_error ############################
@@ -10,108 +13,77 @@ serialization_error::serialization_error(const std::string& message) : runtime_e
 //############################ Serializer ############################
 
 void Serializer::checkSize(uint64_t itemSize) {
-	if(serializedData.size() + itemSize > limit) {
-		throw serialization_error("Out of space! Requested size: " + std::to_string(serializedData.size() + itemSize) + " | Limit: " + std::to_string(limit));
+	if(getDataLength() + itemSize > limit) {
+		throw serialization_error("Out of space! Requested size: " + std::to_string(getDataLength() + itemSize) + " | Limit: " + std::to_string(limit));
+	}
+	if(sink && serializedData.size() + itemSize > bufferSize) {
+		flush();
 	}
 }
 
-Serializer::Serializer() : serializedData(), limit(-1) {}
+void Serializer::append(const int8_t* data, uint64_t size) {
+	//Callers check the size before
+	if(size == 0) {
+		return;
+	}
+	serializedData.reserve(static_cast<uint32_t>(serializedData.size() + size));
+	std::memcpy(&serializedData.getModifiableData()[serializedData.size()], data, size);
+	serializedData.manuallySetSize(static_cast<uint32_t>(serializedData.size() + size));
+}
 
-Serializer::Serializer(uint64_t limit) : serializedData(static_cast<uint32_t>(limit)), limit(limit) {}
+Serializer::Serializer() : serializedData(), limit(-1), sink(nullptr), bufferSize(0), flushedLength(0) {}
+
+Serializer::Serializer(uint64_t limit) : serializedData(static_cast<uint32_t>(limit)), limit(limit), sink(nullptr), bufferSize(0), flushedLength(0) {}
+
+Serializer::Serializer(OutputSink* sink, uint64_t bufferSize) : serializedData(static_cast<uint32_t>(bufferSize)), limit(-1), sink(sink), bufferSize(bufferSize), flushedLength(0) {}
 
 Serializer::Serializer(Serializer&& serializer) noexcept {
 	serializedData = std::move(serializer.serializedData);
 	limit = serializer.limit;
+	sink = serializer.sink;
+	serializer.sink = nullptr;
+	bufferSize = serializer.bufferSize;
+	flushedLength = serializer.flushedLength;
 }
 
 void Serializer::serialize(uint8_t value) {
-	checkSize(1);
-	serializedData.add(*reinterpret_cast<const int8_t*>(&value));
+	writeValue(value);
 }
 
 void Serializer::serialize(int8_t value) {
-	checkSize(1);
-	serializedData.add(value);
+	writeValue(value);
 }
 
 void Serializer::serialize(uint16_t value) {
-	checkSize(2);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
+	writeValue(value);
 }
 
 void Serializer::serialize(int16_t value) {
-	checkSize(2);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
+	writeValue(value);
 }
 
 void Serializer::serialize(uint32_t value) {
-	checkSize(4);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
-	serializedData.add(data[2]);
-	serializedData.add(data[3]);
+	writeValue(value);
 }
 
 void Serializer::serialize(int32_t value) {
-	checkSize(4);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
-	serializedData.add(data[2]);
-	serializedData.add(data[3]);
+	writeValue(value);
 }
 
 void Serializer::serialize(uint64_t value) {
-	checkSize(8);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
-	serializedData.add(data[2]);
-	serializedData.add(data[3]);
-	serializedData.add(data[4]);
-	serializedData.add(data[5]);
-	serializedData.add(data[6]);
-	serializedData.add(data[7]);
+	writeValue(value);
 }
 
 void Serializer::serialize(int64_t value) {
-	checkSize(8);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
-	serializedData.add(data[2]);
-	serializedData.add(data[3]);
-	serializedData.add(data[4]);
-	serializedData.add(data[5]);
-	serializedData.add(data[6]);
-	serializedData.add(data[7]);
+	writeValue(value);
 }
 
 void Serializer::serialize(float value) {
-	checkSize(4);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
-	serializedData.add(data[2]);
-	serializedData.add(data[3]);
+	writeValue(value);
 }
 
 void Serializer::serialize(double value) {
-	checkSize(8);
-	const int8_t* data = reinterpret_cast<const int8_t*>(&value);
-	serializedData.add(data[0]);
-	serializedData.add(data[1]);
-	serializedData.add(data[2]);
-	serializedData.add(data[3]);
-	serializedData.add(data[4]);
-	serializedData.add(data[5]);
-	serializedData.add(data[6]);
-	serializedData.add(data[7]);
+	writeValue(value);
 }
 
 void Serializer::serialize(bool value) {
@@ -122,21 +94,38 @@ void Serializer::serialize(bool value) {
 void Serializer::serialize(const std::string& value) {
 	uint64_t size = static_cast<uint64_t>(value.length()) + 1;
 	checkSize(size);
-	const int8_t* data = reinterpret_cast<const int8_t*>(value.c_str());
-	for(uint64_t i = 0;i < size;i++) {
-		serializedData.add(data[i]);
-	}
+	append(reinterpret_cast<const int8_t*>(value.c_str()), size);
 }
 
 void Serializer::serialize(int8_t const* data, uint64_t size) {
 	checkSize(size);
-	for(uint64_t i = 0;i < size;i++) {
-		serializedData.add(data[i]);
+	if(sink && size >= bufferSize) {
+		//Don't copy big data into the buffer first
+		sink->write(data, size);
+		flushedLength += size;
+		return;
+	}
+	append(data, size);
+}
+
+void Serializer::flush() {
+	if(sink && serializedData.size() > 0) {
+		sink->write(serializedData.getData(), serializedData.size());
+		flushedLength += serializedData.size();
+		serializedData.clear();
+	}
+}
+
+void Serializer::finish() {
+	if(sink) {
+		flush();
+		sink->finish();
 	}
 }
 
 void Serializer::reset() {
 	serializedData.clear();
+	flushedLength = 0;
 }
 
 int8_t* Serializer::getSerializedData() {
@@ -148,7 +137,7 @@ int8_t* Serializer::extractSerializedData() {
 }
 
 uint64_t Serializer::getDataLength() const {
-	return serializedData.size();
+	return flushedLength + serializedData.size();
 }
 
 uint64_t Serializer::getLimit() const {
@@ -158,12 +147,19 @@ uint64_t Serializer::getLimit() const {
 Serializer& Serializer::operator=(Serializer&& serializer) noexcept {
 	serializedData = std::move(serializer.serializedData);
 	limit = serializer.limit;
+	sink = serializer.sink;
+	serializer.sink = nullptr;
+	bufferSize = serializer.bufferSize;
+	flushedLength = serializer.flushedLength;
 	return *this;
 }
 
 //############################ Deserializer ############################
 
 void Deserializer::checkSize(uint64_t itemSize) {
+	if(source && (currentOffset + itemSize - baseOffset) > dataLength) {
+		fill(itemSize);
+	}
 	if(serializedData) {
 		if((currentOffset + itemSize - baseOffset) > dataLength) {
 			throw serialization_error("Out of data! Requested size: " + std::to_string(currentOffset + itemSize - baseOffset) + " | Actual size: " + std::to_string(dataLength));
@@ -173,9 +169,36 @@ void Deserializer::checkSize(uint64_t itemSize) {
 	}
 }
 
-Deserializer::Deserializer(bool cleanupData) : serializedData(nullptr), dataLength(0), currentOffset(0), baseOffset(0), cleanupData(cleanupData) {}
+void Deserializer::fill(uint64_t itemSize) {
+	//Move the remaining bytes to the front (or into a bigger buffer) and read as much as fits behind them
+	uint64_t remainingBytes = dataLength - (currentOffset - baseOffset);
+	if(itemSize > bufferSize) {
+		uint64_t newBufferSize = std::max(itemSize, bufferSize * 2);
+		int8_t* newData = new int8_t[newBufferSize];
+		std::memcpy(newData, &serializedData[currentOffset], remainingBytes);
+		delete[] serializedData;
+		serializedData = newData;
+		bufferSize = newBufferSize;
+	} else {
+		std::memmove(serializedData, &serializedData[currentOffset], remainingBytes);
+	}
+	baseOffset = 0;
+	currentOffset = 0;
+	dataLength = remainingBytes;
+	while(dataLength < bufferSize) {
+		uint64_t readBytes = source->read(&serializedData[dataLength], bufferSize - dataLength);
+		if(readBytes == 0) {
+			break;
+		}
+		dataLength += readBytes;
+	}
+}
 
-Deserializer::Deserializer(int8_t* serializedData, uint64_t dataLength, uint64_t baseOffset, bool cleanupData) : serializedData(serializedData), dataLength(dataLength), currentOffset(baseOffset), baseOffset(baseOffset), cleanupData(cleanupData) {}
+Deserializer::Deserializer(bool cleanupData) : serializedData(nullptr), dataLength(0), currentOffset(0), baseOffset(0), cleanupData(cleanupData), source(nullptr), bufferSize(0) {}
+
+Deserializer::Deserializer(int8_t* serializedData, uint64_t dataLength, uint64_t baseOffset, bool cleanupData) : serializedData(serializedData), dataLength(dataLength), currentOffset(baseOffset), baseOffset(baseOffset), cleanupData(cleanupData), source(nullptr), bufferSize(0) {}
+
+Deserializer::Deserializer(InputSource* source, uint64_t bufferSize) : serializedData(new int8_t[bufferSize > 0 ? bufferSize : 1]), dataLength(0), currentOffset(0), baseOffset(0), cleanupData(true), source(source), bufferSize(bufferSize > 0 ? bufferSize : 1) {}
 
 Deserializer::Deserializer(Deserializer&& deserializer) noexcept {
 	serializedData = deserializer.serializedData;
@@ -187,6 +210,9 @@ Deserializer::Deserializer(Deserializer&& deserializer) noexcept {
 	currentOffset = deserializer.currentOffset;
 	deserializer.currentOffset = 0;
 	cleanupData = deserializer.cleanupData;
+	source = deserializer.source;
+	deserializer.source = nullptr;
+	bufferSize = deserializer.bufferSize;
 }
 
 Deserializer::~Deserializer() {
@@ -198,64 +224,44 @@ Deserializer::~Deserializer() {
 }
 
 void Deserializer::deserialize(uint8_t& result) {
-	checkSize(1);
-	result = *reinterpret_cast<uint8_t*>(&serializedData[currentOffset]);
-	currentOffset += 1;
+	readValue(result);
 }
 
 
 void Deserializer::deserialize(int8_t& result) {
-	checkSize(1);
-	result = serializedData[currentOffset];
-	currentOffset += 1;
+	readValue(result);
 }
 
 void Deserializer::deserialize(uint16_t& result) {
-	checkSize(2);
-	result = *reinterpret_cast<uint16_t*>(&serializedData[currentOffset]);
-	currentOffset += 2;
+	readValue(result);
 }
 
 void Deserializer::deserialize(int16_t& result) {
-	checkSize(2);
-	result = *reinterpret_cast<int16_t*>(&serializedData[currentOffset]);
-	currentOffset += 2;
+	readValue(result);
 }
 
 void Deserializer::deserialize(uint32_t& result) {
-	checkSize(4);
-	result = *reinterpret_cast<uint32_t*>(&serializedData[currentOffset]);
-	currentOffset += 4;
+	readValue(result);
 }
 
 void Deserializer::deserialize(int32_t& result) {
-	checkSize(4);
-	result = *reinterpret_cast<int32_t*>(&serializedData[currentOffset]);
-	currentOffset += 4;
+	readValue(result);
 }
 
 void Deserializer::deserialize(uint64_t& result) {
-	checkSize(8);
-	result = *reinterpret_cast<uint64_t*>(&serializedData[currentOffset]);
-	currentOffset += 8;
+	readValue(result);
 }
 
 void Deserializer::deserialize(int64_t& result) {
-	checkSize(8);
-	result = *reinterpret_cast<int64_t*>(&serializedData[currentOffset]);
-	currentOffset += 8;
+	readValue(result);
 }
 
 void Deserializer::deserialize(float& result) {
-	checkSize(4);
-	result = *reinterpret_cast<float*>(&serializedData[currentOffset]);
-	currentOffset += 4;
+	readValue(result);
 }
 
 void Deserializer::deserialize(double& result) {
-	checkSize(8);
-	result = *reinterpret_cast<double*>(&serializedData[currentOffset]);
-	currentOffset += 8;
+	readValue(result);
 }
 
 void Deserializer::deserialize(bool& result) {
@@ -267,7 +273,13 @@ void Deserializer::deserialize(bool& result) {
 void Deserializer::deserialize(std::string& result) {
 	if(serializedData) {
 		uint64_t currentLength = 1;
-		while((currentOffset + currentLength - baseOffset) <= dataLength && serializedData[currentOffset + currentLength - 1] != 0) {
+		while(true) {
+			if(source && (currentOffset + currentLength - baseOffset) > dataLength) {
+				fill(currentLength);
+			}
+			if((currentOffset + currentLength - baseOffset) > dataLength || serializedData[currentOffset + currentLength - 1] == 0) {
+				break;
+			}
 			currentLength++;
 		}
 		if((currentOffset + currentLength - baseOffset) > dataLength) {
@@ -295,6 +307,7 @@ void Deserializer::setData(int8_t* serializedData, uint64_t dataLength, uint64_t
 	this->dataLength = dataLength;
 	this->baseOffset = baseOffset;
 	currentOffset = baseOffset;
+	source = nullptr;
 }
 
 const int8_t* Deserializer::getSerializedData() const {
@@ -327,5 +340,8 @@ Deserializer& Deserializer::operator=(Deserializer&& deserializer) noexcept {
 	currentOffset = deserializer.currentOffset;
 	deserializer.currentOffset = 0;
 	cleanupData = deserializer.cleanupData;
+	source = deserializer.source;
+	deserializer.source = nullptr;
+	bufferSize = deserializer.bufferSize;
 	return *this;
 }
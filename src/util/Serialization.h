@@ -3,11 +3,32 @@
 
 #include <string>
 #include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 #include "Collections.h"
+#include "Streams.h"
 #include <stdexcept>
 
+constexpr uint64_t SERIALIZER_STREAM_BUFFER_SIZE = 1024 * 1024;
+
+//Serialized data is little endian on every host. Little endian hosts copy values and arrays as they are
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define AEX_BIG_ENDIAN
+#endif
+
 namespace AEX {
 
+	template<typename T>
+	inline T toLittleEndian(T value) noexcept {
+#ifdef AEX_BIG_ENDIAN
+		int8_t* bytes = reinterpret_cast<int8_t*>(&value);
+		std::reverse(bytes, bytes + sizeof(T));
+#endif
+		return value;
+	}
+
 	class serialization_error : public std::runtime_error {
 		private:
 		protected:
@@ -19,12 +40,25 @@ namespace AEX {
 		private:
 			ArrayList<int8_t> serializedData;
 			uint64_t limit;
+			OutputSink* sink;
+			uint64_t bufferSize;
+			uint64_t flushedLength;
 
 			void checkSize(uint64_t itemSize);
+			void append(const int8_t* data, uint64_t size);
+
+			template<typename T>
+			void writeValue(T value) {
+				checkSize(sizeof(T));
+				value = toLittleEndian(value);
+				append(reinterpret_cast<const int8_t*>(&value), sizeof(T));
+			}
 		protected:
 		public:
 			Serializer();
 			Serializer(uint64_t limit);
+			//Streaming mode: at most "bufferSize" bytes are buffered before they are written to the sink, bigger data is written directly. Does not take ownership of the sink
+			Serializer(OutputSink* sink, uint64_t bufferSize = SERIALIZER_STREAM_BUFFER_SIZE);
 			Serializer(Serializer&& serializer) noexcept;
 			void serialize(uint8_t value);
 			void serialize(int8_t value);
@@ -39,9 +73,15 @@ namespace AEX {
 			void serialize(bool value);
 			void serialize(const std::string& value);
 			void serialize(int8_t const* data, uint64_t size);
+			//Writes the buffered data to the sink (streaming mode only)
+			void flush();
+			//Flushes and finishes the sink (streaming mode only)
+			void finish();
 			void reset();
+			//Buffered data only in streaming mode
 			int8_t* getSerializedData();
 			int8_t* extractSerializedData();
+			//Includes the data already written to the sink
 			uint64_t getDataLength() const;
 			uint64_t getLimit() const;
 			Serializer& operator=(Serializer&& serializer) noexcept;
@@ -51,6 +91,30 @@ namespace AEX {
 				value->serialize(*this);
 			}
 
+			//Writes "count" values at once (without count)
+			template<typename T>
+			void serializeArray(T const* data, uint64_t count) {
+				static_assert(std::is_arithmetic<T>::value, "Only arithmetic types can be serialized as array!");
+				//Empty vectors may have no data at all, which must not be passed to memcpy
+				if(count == 0) {
+					return;
+				}
+#ifdef AEX_BIG_ENDIAN
+				for(uint64_t i = 0;i < count;i++) {
+					writeValue(data[i]);
+				}
+#else
+				serialize(reinterpret_cast<int8_t const*>(data), count * sizeof(T));
+#endif
+			}
+
+			//Writes the count followed by the values
+			template<typename T>
+			void serialize(const std::vector<T>& values) {
+				serialize(static_cast<uint64_t>(values.size()));
+				serializeArray(values.data(), values.size());
+			}
+
 			Serializer(const Serializer& serializer) = delete;
 			Serializer& operator=(const Serializer& serializer) = delete;
 	};
@@ -62,12 +126,25 @@ namespace AEX {
 			uint64_t currentOffset;
 			uint64_t baseOffset;
 			bool cleanupData;
+			InputSource* source;
+			uint64_t bufferSize;
 
 			void checkSize(uint64_t itemSize);
+			void fill(uint64_t itemSize);
+
+			template<typename T>
+			void readValue(T& result) {
+				checkSize(sizeof(T));
+				std::memcpy(&result, &serializedData[currentOffset], sizeof(T));
+				result = toLittleEndian(result);
+				currentOffset += sizeof(T);
+			}
 		protected:
 		public:
 			Deserializer(bool cleanupData = false);
 			Deserializer(int8_t* serializedData, uint64_t dataLength, uint64_t baseOffset = 0, bool cleanupData = false);
+			//Streaming mode: reads "bufferSize" bytes at once from the source, the buffer grows if a single item is bigger. Does not take ownership of the source
+			Deserializer(InputSource* source, uint64_t bufferSize = SERIALIZER_STREAM_BUFFER_SIZE);
 			Deserializer(Deserializer&& deserializer) noexcept;
 			~Deserializer();
 			void deserialize(uint8_t& result);
@@ -82,6 +159,7 @@ namespace AEX {
 			void deserialize(double& result);
 			void deserialize(bool& result);
 			void deserialize(std::string& result);
+			//In streaming mode "data" is only valid until the next call
 			void deserialize(int8_t*& data, uint64_t size);
 			void setData(int8_t* serializedData, uint64_t dataLength, uint64_t baseOffset);
 			const int8_t* getSerializedData() const;
@@ -96,6 +174,32 @@ namespace AEX {
 				value->deserialize(*this);
 			}
 
+			//Reads "count" values at once into "result", see Serializer::serializeArray
+			template<typename T>
+			void deserializeArray(T* result, uint64_t count) {
+				static_assert(std::is_arithmetic<T>::value, "Only arithmetic types can be deserialized as array!");
+				//E.g. the sizes of 0-dim tensors, "result" may be nullptr then
+				if(count == 0) {
+					return;
+				}
+				checkSize(count * sizeof(T));
+				std::memcpy(result, &serializedData[currentOffset], count * sizeof(T));
+#ifdef AEX_BIG_ENDIAN
+				for(uint64_t i = 0;i < count;i++) {
+					result[i] = toLittleEndian(result[i]);
+				}
+#endif
+				currentOffset += count * sizeof(T);
+			}
+
+			template<typename T>
+			void deserialize(std::vector<T>& result) {
+				uint64_t count;
+				deserialize(count);
+				result.resize(count);
+				deserializeArray(result.data(), count);
+			}
+
 			Deserializer(const Deserializer& deserializer) = delete;
 			Deserializer& operator=(const Deserializer& deserializer) = delete;
 	};
@@ -0,0 +1,112 @@
+#include "Streams.h"
+
+#include "IOUtils.h"
+#include <cstring>
+#include <filesystem>
+
+using namespace AEX;
+
+//############################ OutputSink ############################
+
+OutputSink::~OutputSink() {}
+
+void OutputSink::finish() {}
+
+//############################ InputSource ############################
+
+InputSource::~InputSource() {}
+
+//############################ FileOutputSink ############################
+
+FileOutputSink::FileOutputSink(const std::string& filename, bool recreate) : stream(), filename(filename) {
+	std::filesystem::path fileLocation = std::filesystem::u8path(filename);
+	stream.open(fileLocation, std::ios::binary | std::ios::out | (recreate ? std::ios::trunc : std::ios::app));
+	if(!stream) {
+		throw io_error("Failed to open the stream! Filename: " + filename);
+	}
+}
+
+FileOutputSink::~FileOutputSink() {
+	if(stream.is_open()) {
+		stream.close();
+	}
+}
+
+void FileOutputSink::write(const int8_t* data, uint64_t size) {
+	stream.write(reinterpret_cast<const char*>(data), size);
+	if(!stream) {
+		throw io_error("Failed to write to the stream! Filename: " + filename);
+	}
+}
+
+void FileOutputSink::finish() {
+	stream.flush();
+	stream.close();
+	if(!stream) {
+		throw io_error("Failed to close the stream! Filename: " + filename);
+	}
+}
+
+//############################ FileInputSource ############################
+
+FileInputSource::FileInputSource(const std::string& filename) : stream(), filename(filename) {
+	std::filesystem::path fileLocation = std::filesystem::u8path(filename);
+	if(!std::filesystem::exists(fileLocation) || !std::filesystem::is_regular_file(fileLocation)) {
+		throw io_error("File not found! Filename: " + filename);
+	}
+	stream.open(fileLocation, std::ios::binary | std::ios::in);
+	if(!stream) {
+		throw io_error("Failed to open the stream! Filename: " + filename);
+	}
+}
+
+FileInputSource::~FileInputSource() {
+	stream.close();
+}
+
+uint64_t FileInputSource::read(int8_t* buffer, uint64_t size) {
+	stream.read(reinterpret_cast<char*>(buffer), size);
+	if(stream.bad()) {
+		throw io_error("Failed to read from the stream! Filename: " + filename);
+	}
+	return static_cast<uint64_t>(stream.gcount());
+}
+
+//############################ MemoryOutputSink ############################
+
+MemoryOutputSink::MemoryOutputSink() : data() {}
+
+void MemoryOutputSink::write(const int8_t* data, uint64_t size) {
+	if(size == 0) {
+		return;
+	}
+	this->data.reserve(static_cast<uint32_t>(this->data.size() + size));
+	std::memcpy(&this->data.getModifiableData()[this->data.size()], data, size);
+	this->data.manuallySetSize(static_cast<uint32_t>(this->data.size() + size));
+}
+
+int8_t* MemoryOutputSink::getData() {
+	return data.getModifiableData();
+}
+
+int8_t* MemoryOutputSink::extractData() {
+	return data.extractAndClear();
+}
+
+uint64_t MemoryOutputSink::getDataLength() const {
+	return data.size();
+}
+
+//############################ MemoryInputSource ############################
+
+MemoryInputSource::MemoryInputSource(const int8_t* data, uint64_t dataLength) : data(data), dataLength(dataLength), currentOffset(0) {}
+
+uint64_t MemoryInputSource::read(int8_t* buffer, uint64_t size) {
+	uint64_t remainingBytes = dataLength - currentOffset;
+	if(size > remainingBytes) {
+		size = remainingBytes;
+	}
+	std::memcpy(buffer, &data[currentOffset], size);
+	currentOffset += size;
+	return size;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include "Collections.h"
+
+namespace AEX {
+
+	//Destination of a Serializer in streaming mode
+	class OutputSink {
+		private:
+		protected:
+		public:
+			virtual ~OutputSink();
+			virtual void write(const int8_t* data, uint64_t size) = 0;
+			//Writes everything buffered. No data may be written afterwards
+			virtual void finish();
+	};
+
+	//Source of a Deserializer in streaming mode
+	class InputSource {
+		private:
+		protected:
+		public:
+			virtual ~InputSource();
+			//Reads up to "size" bytes and returns how many have been read. 0 means the end has been reached
+			virtual uint64_t read(int8_t* buffer, uint64_t size) = 0;
+	};
+
+	class FileOutputSink : public OutputSink {
+		private:
+			std::ofstream stream;
+			std::string filename;
+		protected:
+		public:
+			FileOutputSink(const std::string& filename, bool recreate);
+			~FileOutputSink() override;
+			void write(const int8_t* data, uint64_t size) override;
+			void finish() override;
+	};
+
+	class FileInputSource : public InputSource {
+		private:
+			std::ifstream stream;
+			std::string filename;
+		protected:
+		public:
+			explicit FileInputSource(const std::string& filename);
+			~FileInputSource() override;
+			uint64_t read(int8_t* buffer, uint64_t size) override;
+	};
+
+	class MemoryOutputSink : public OutputSink {
+		private:
+			ArrayList<int8_t> data;
+		protected:
+		public:
+			MemoryOutputSink();
+			void write(const int8_t* data, uint64_t size) override;
+			int8_t* getData();
+			int8_t* extractData();
+			uint64_t getDataLength() const;
+	};
+
+	//Does not take ownership of the data
+	class MemoryInputSource : public InputSource {
+		private:
+			const int8_t* data;
+			uint64_t dataLength;
+			uint64_t currentOffset;
+		protected:
+		public:
+			MemoryInputSource(const int8_t* data, uint64_t dataLength);
+			uint64_t read(int8_t* buffer, uint64_t size) override;
+	};
+}
@@ -0,0 +1,147 @@
+#include "WorkerPool.h"
+
+using namespace PLANS;
+
+//############################ WorkerPool ############################
+
+// PUBLIC
+
+WorkerPool::WorkerPool(uint32_t numOfThreads) : threads(), queues(), batchMutex(), batchStarted(), batchFinished(), currentTask(nullptr), batchGeneration(0), activeWorkers(0), pendingTasks(0), stopping(false) {
+	if(numOfThreads == 0) {
+		numOfThreads = std::thread::hardware_concurrency();
+		if(numOfThreads == 0) {
+			numOfThreads = 1;	// Not computable on this platform. 
+		}
+	}
+	// Create queues first, as the workers access all of them when stealing. 
+	for(uint32_t i = 0; i < numOfThreads; i++) {
+		queues.push_back(new TaskQueue());
+	}
+	// Start workers. Queue 0 belongs to the calling thread. 
+	for(uint32_t i = 1; i < numOfThreads; i++) {
+		threads.emplace_back(&WorkerPool::workerLoop, this, i);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	batchMutex.lock();
+	stopping = true;
+	batchMutex.unlock();
+	batchStarted.notify_all();
+	for(std::thread& thread : threads) {
+		thread.join();
+	}
+	threads.clear();
+	for(TaskQueue* queue : queues) {
+		delete queue;
+	}
+	queues.clear();
+}
+
+void WorkerPool::runBatch(uint32_t numOfTasks, const Task& task) {
+	if(numOfTasks == 0) {
+		return;
+	}
+	if(threads.empty() || numOfTasks == 1) {
+		// Nothing to distribute. 
+		for(uint32_t i = 0; i < numOfTasks; i++) {
+			task(i);
+		}
+		return;
+	}
+
+	// Deal contiguous ranges of task indices to the queues. 
+	uint32_t numOfQueues = static_cast<uint32_t>(queues.size());
+	for(uint32_t q = 0; q < numOfQueues; q++) {
+		uint32_t first = static_cast<uint32_t>((static_cast<uint64_t>(numOfTasks) * q) / numOfQueues);
+		uint32_t last = static_cast<uint32_t>((static_cast<uint64_t>(numOfTasks) * (q + 1)) / numOfQueues);
+		std::lock_guard<std::mutex> queueLock(queues[q]->mutex);
+		for(uint32_t i = first; i < last; i++) {
+			queues[q]->taskIndices.push_back(i);
+		}
+	}
+	pendingTasks.store(numOfTasks);
+
+	// Wake workers. 
+	batchMutex.lock();
+	currentTask = &task;
+	batchGeneration++;
+	batchMutex.unlock();
+	batchStarted.notify_all();
+
+	// Work on the batch as well. 
+	runTasks(0, task);
+
+	// Wait until all tasks finished and no worker references "task" anymore. 
+	std::unique_lock<std::mutex> lock(batchMutex);
+	batchFinished.wait(lock, [this]() { return pendingTasks.load() == 0 && activeWorkers == 0; });
+	currentTask = nullptr;	// Workers waking up late must not touch "task". 
+}
+
+uint32_t WorkerPool::getNumOfThreads() const {
+	return static_cast<uint32_t>(queues.size());
+}
+
+// PRIVATE
+
+void WorkerPool::workerLoop(uint32_t queueIndex) {
+	uint64_t seenGeneration = 0;
+	const Task* task;
+	while(true) {
+		// Wait for the next batch. 
+		std::unique_lock<std::mutex> lock(batchMutex);
+		batchStarted.wait(lock, [this, seenGeneration]() { return stopping || batchGeneration != seenGeneration; });
+		if(stopping) {
+			return;
+		}
+		seenGeneration = batchGeneration;
+		task = currentTask;
+		if(task == nullptr) {
+			continue;	// The batch already finished without this worker. 
+		}
+		activeWorkers++;
+		lock.unlock();
+
+		runTasks(queueIndex, *task);
+
+		lock.lock();
+		activeWorkers--;
+		lock.unlock();
+		batchFinished.notify_one();
+	}
+}
+
+void WorkerPool::runTasks(uint32_t queueIndex, const Task& task) {
+	uint32_t taskIndex;
+	while(popTask(queueIndex, taskIndex) || stealTask(queueIndex, taskIndex)) {
+		task(taskIndex);
+		pendingTasks.fetch_sub(1);
+	}
+}
+
+bool WorkerPool::popTask(uint32_t queueIndex, uint32_t& taskIndex) {
+	TaskQueue* queue = queues[queueIndex];
+	std::lock_guard<std::mutex> lock(queue->mutex);
+	if(queue->taskIndices.empty()) {
+		return false;
+	}
+	taskIndex = queue->taskIndices.front();
+	queue->taskIndices.pop_front();
+	return true;
+}
+
+bool WorkerPool::stealTask(uint32_t queueIndex, uint32_t& taskIndex) {
+	uint32_t numOfQueues = static_cast<uint32_t>(queues.size());
+	// Start with the next queue, so thieves spread over the victims. 
+	for(uint32_t i = 1; i < numOfQueues; i++) {
+		TaskQueue* victim = queues[(queueIndex + i) % numOfQueues];
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if(!victim->taskIndices.empty()) {
+			// Steal from the back, the owner pops from the front. 
+			taskIndex = victim->taskIndices.back();
+			victim->taskIndices.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
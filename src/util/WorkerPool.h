@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace PLANS {
+
+	//############################ WorkerPool ############################
+
+	/*
+	*	Fixed set of threads executing batches of indexed tasks. 
+	*		- The thread calling "runBatch" works on the batch as well and returns once all tasks of the batch finished (barrier). 
+	*		- Every thread owns a queue of task indices. A thread which ran out of tasks steals from the back of the other queues, so a few slow tasks (e.g. environment resets) don't stall the whole batch. 
+	*/
+	class WorkerPool {
+		public:
+			using Task = std::function<void(uint32_t)>;
+
+			// "numOfThreads" includes the calling thread. 0 uses one thread per hardware thread. 
+			explicit WorkerPool(uint32_t numOfThreads = 0);
+			~WorkerPool();
+
+			// Runs "task" for every index in [0, numOfTasks) and waits until all of them finished. Not reentrant. 
+			void runBatch(uint32_t numOfTasks, const Task& task);
+
+			uint32_t getNumOfThreads() const;
+		protected:
+		private:
+			struct TaskQueue {
+				std::mutex mutex;
+				std::deque<uint32_t> taskIndices;
+			};
+
+			std::vector<std::thread> threads;
+			std::vector<TaskQueue*> queues;		// One per thread, index 0 belongs to the thread calling "runBatch". 
+
+			std::mutex batchMutex;
+			std::condition_variable batchStarted;
+			std::condition_variable batchFinished;
+			const Task* currentTask;			// nullptr while no batch is running. 
+			uint64_t batchGeneration;
+			uint32_t activeWorkers;				// Worker threads currently working on "currentTask". 
+			std::atomic<uint32_t> pendingTasks;
+			bool stopping;
+
+			void workerLoop(uint32_t queueIndex);
+			void runTasks(uint32_t queueIndex, const Task& task);
+			bool popTask(uint32_t queueIndex, uint32_t& taskIndex);
+			bool stealTask(uint32_t queueIndex, uint32_t& taskIndex);
+	};
+
+}
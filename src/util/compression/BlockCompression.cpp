@@ -0,0 +1,237 @@
+#include "BlockCompression.h"
+
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <zlib/zlib.h>
+
+using namespace AEX;
+
+constexpr uint64_t BLOCK_INDEX_ENTRY_SIZE = 32;
+constexpr uint32_t BLOCK_FLAG_STORED = 1;
+
+struct BlockIndexEntry {
+	uint64_t offset;
+	uint64_t compressedSize;
+	uint64_t rawSize;
+	uint32_t checksum;
+	uint32_t flags;
+};
+
+static void writeLittleEndian(int8_t* target, uint64_t value, uint32_t numOfBytes) {
+	for(uint32_t i = 0;i < numOfBytes;i++) {
+		target[i] = static_cast<int8_t>((value >> (i * 8)) & 0xFF);
+	}
+}
+
+static uint64_t readLittleEndian(const int8_t* source, uint32_t numOfBytes) {
+	uint64_t value = 0;
+	for(uint32_t i = 0;i < numOfBytes;i++) {
+		value |= static_cast<uint64_t>(static_cast<uint8_t>(source[i])) << (i * 8);
+	}
+	return value;
+}
+
+//Runs "task" for every block index, spread dynamically over the threads. Rethrows the first error after all threads finished
+static void runBlocksParallel(uint64_t numOfBlocks, uint32_t numOfThreads, const std::function<void(uint64_t)>& task) {
+	if(numOfThreads == 0) {
+		numOfThreads = std::thread::hardware_concurrency();
+		if(numOfThreads == 0) {
+			numOfThreads = 1;
+		}
+	}
+	if(numOfThreads > numOfBlocks) {
+		numOfThreads = static_cast<uint32_t>(numOfBlocks);
+	}
+	std::atomic<uint64_t> nextBlock(0);
+	std::atomic<bool> failed(false);
+	std::mutex errorMutex;
+	std::string errorMessage;
+	auto worker = [&]() {
+		uint64_t blockIndex;
+		while(!failed.load() && (blockIndex = nextBlock.fetch_add(1)) < numOfBlocks) {
+			try {
+				task(blockIndex);
+			} catch(std::exception& e) {
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if(!failed.load()) {
+					errorMessage = e.what();
+					failed.store(true);
+				}
+			} catch(...) {
+				//Nothing may escape the thread, std::terminate would be called
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if(!failed.load()) {
+					errorMessage = "Unknown error in block " + std::to_string(blockIndex) + "!";
+					failed.store(true);
+				}
+			}
+		}
+	};
+	std::vector<std::thread> threads;
+	for(uint32_t i = 1;i < numOfThreads;i++) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for(std::thread& thread : threads) {
+		thread.join();
+	}
+	if(failed.load()) {
+		throw block_compression_error(errorMessage);
+	}
+}
+
+//############################ block_compression_error ############################
+
+block_compression_error::block_compression_error(const std::string& message) : runtime_error(message) {}
+
+//############################ BlockCompressor ############################
+
+BlockCompressor::BlockCompressor(uint32_t level, uint32_t numOfThreads, uint32_t blockSize) : level(level), numOfThreads(numOfThreads), blockSize(blockSize) {
+	if(this->level > 9) {
+		this->level = 9;
+	}
+	if(this->blockSize == 0) {
+		this->blockSize = BLOCK_COMPRESSION_DEFAULT_BLOCK_SIZE;
+	}
+}
+
+int8_t* BlockCompressor::compress(int8_t* inputData, uint64_t inputSize, uint64_t& outputSize) {
+	uint64_t numOfBlocks = (inputSize + blockSize - 1) / blockSize;
+	std::vector<BlockIndexEntry> index = std::vector<BlockIndexEntry>(numOfBlocks);
+	std::vector<std::vector<int8_t>> compressedBlocks = std::vector<std::vector<int8_t>>(numOfBlocks);
+
+	//Compress the blocks independently. Blocks which don't shrink are stored
+	runBlocksParallel(numOfBlocks, numOfThreads, [&](uint64_t blockIndex) {
+		BlockIndexEntry& entry = index[blockIndex];
+		const Bytef* rawData = reinterpret_cast<const Bytef*>(&inputData[blockIndex * blockSize]);
+		entry.rawSize = (blockIndex == numOfBlocks - 1) ? inputSize - blockIndex * blockSize : blockSize;
+		entry.checksum = static_cast<uint32_t>(crc32(0L, rawData, static_cast<uInt>(entry.rawSize)));
+		entry.flags = BLOCK_FLAG_STORED;
+		entry.compressedSize = entry.rawSize;
+		if(level == BLOCK_COMPRESSION_STORE_ONLY) {
+			return;
+		}
+		std::vector<int8_t>& buffer = compressedBlocks[blockIndex];
+		uLongf bufferSize = compressBound(static_cast<uLong>(entry.rawSize));
+		buffer.resize(bufferSize);
+		if(compress2(reinterpret_cast<Bytef*>(buffer.data()), &bufferSize, rawData, static_cast<uLong>(entry.rawSize), static_cast<int>(level)) != Z_OK) {
+			throw block_compression_error("Failed to compress block " + std::to_string(blockIndex) + "!");
+		}
+		if(bufferSize < entry.rawSize) {
+			entry.flags = 0;
+			entry.compressedSize = bufferSize;
+			buffer.resize(bufferSize);
+		} else {
+			buffer.clear();
+		}
+	});
+
+	//Assemble header, blocks, index and footer
+	outputSize = BLOCK_COMPRESSION_HEADER_SIZE + numOfBlocks * BLOCK_INDEX_ENTRY_SIZE + BLOCK_COMPRESSION_FOOTER_SIZE;
+	for(const BlockIndexEntry& entry : index) {
+		outputSize += entry.compressedSize;
+	}
+	int8_t* outputData = new int8_t[outputSize];
+	writeLittleEndian(&outputData[0], BLOCK_COMPRESSION_MAGIC, 4);
+	writeLittleEndian(&outputData[4], BLOCK_COMPRESSION_VERSION, 4);
+	writeLittleEndian(&outputData[8], blockSize, 4);
+	writeLittleEndian(&outputData[12], level, 4);
+	uint64_t position = BLOCK_COMPRESSION_HEADER_SIZE;
+	for(uint64_t i = 0;i < numOfBlocks;i++) {
+		BlockIndexEntry& entry = index[i];
+		entry.offset = position;
+		const int8_t* blockData = (entry.flags & BLOCK_FLAG_STORED) ? &inputData[i * blockSize] : compressedBlocks[i].data();
+		std::memcpy(&outputData[position], blockData, entry.compressedSize);
+		position += entry.compressedSize;
+	}
+	uint64_t indexOffset = position;
+	for(const BlockIndexEntry& entry : index) {
+		writeLittleEndian(&outputData[position], entry.offset, 8);
+		writeLittleEndian(&outputData[position + 8], entry.compressedSize, 8);
+		writeLittleEndian(&outputData[position + 16], entry.rawSize, 8);
+		writeLittleEndian(&outputData[position + 24], entry.checksum, 4);
+		writeLittleEndian(&outputData[position + 28], entry.flags, 4);
+		position += BLOCK_INDEX_ENTRY_SIZE;
+	}
+	writeLittleEndian(&outputData[position], indexOffset, 8);
+	writeLittleEndian(&outputData[position + 8], numOfBlocks, 8);
+	writeLittleEndian(&outputData[position + 16], BLOCK_COMPRESSION_MAGIC, 4);
+	writeLittleEndian(&outputData[position + 20], BLOCK_COMPRESSION_VERSION, 4);
+	return outputData;
+}
+
+//############################ BlockDecompressor ############################
+
+BlockDecompressor::BlockDecompressor(uint32_t numOfThreads) : numOfThreads(numOfThreads) {}
+
+int8_t* BlockDecompressor::decompress(int8_t* inputData, uint64_t inputSize, uint64_t& outputSize) {
+	if(!isBlockCompressed(inputData, inputSize)) {
+		throw block_compression_error("Data is not block compressed!");
+	}
+	if(readLittleEndian(&inputData[4], 4) > BLOCK_COMPRESSION_VERSION) {
+		throw block_compression_error("Unsupported version " + std::to_string(readLittleEndian(&inputData[4], 4)) + "!");
+	}
+
+	//Read and validate the index
+	const int8_t* footer = &inputData[inputSize - BLOCK_COMPRESSION_FOOTER_SIZE];
+	uint64_t indexOffset = readLittleEndian(&footer[0], 8);
+	uint64_t numOfBlocks = readLittleEndian(&footer[8], 8);
+	if(indexOffset < BLOCK_COMPRESSION_HEADER_SIZE || indexOffset > inputSize - BLOCK_COMPRESSION_FOOTER_SIZE || numOfBlocks > (inputSize - BLOCK_COMPRESSION_FOOTER_SIZE - indexOffset) / BLOCK_INDEX_ENTRY_SIZE) {
+		throw block_compression_error("Corrupted block index!");
+	}
+	std::vector<BlockIndexEntry> index = std::vector<BlockIndexEntry>(numOfBlocks);
+	std::vector<uint64_t> outputOffsets = std::vector<uint64_t>(numOfBlocks);
+	outputSize = 0;
+	for(uint64_t i = 0;i < numOfBlocks;i++) {
+		const int8_t* entryData = &inputData[indexOffset + i * BLOCK_INDEX_ENTRY_SIZE];
+		BlockIndexEntry& entry = index[i];
+		entry.offset = readLittleEndian(&entryData[0], 8);
+		entry.compressedSize = readLittleEndian(&entryData[8], 8);
+		entry.rawSize = readLittleEndian(&entryData[16], 8);
+		entry.checksum = static_cast<uint32_t>(readLittleEndian(&entryData[24], 4));
+		entry.flags = static_cast<uint32_t>(readLittleEndian(&entryData[28], 4));
+		if(entry.offset < BLOCK_COMPRESSION_HEADER_SIZE || entry.offset > indexOffset || entry.compressedSize > indexOffset - entry.offset) {
+			throw block_compression_error("Corrupted index entry of block " + std::to_string(i) + "!");
+		}
+		if((entry.flags & BLOCK_FLAG_STORED) && entry.compressedSize != entry.rawSize) {
+			throw block_compression_error("Corrupted index entry of block " + std::to_string(i) + "!");
+		}
+		outputOffsets[i] = outputSize;
+		outputSize += entry.rawSize;
+	}
+
+	//Decompress the blocks directly into their place in the output
+	int8_t* outputData = new int8_t[outputSize];
+	try {
+		runBlocksParallel(numOfBlocks, numOfThreads, [&](uint64_t blockIndex) {
+			const BlockIndexEntry& entry = index[blockIndex];
+			Bytef* target = reinterpret_cast<Bytef*>(&outputData[outputOffsets[blockIndex]]);
+			if(entry.flags & BLOCK_FLAG_STORED) {
+				std::memcpy(target, &inputData[entry.offset], entry.rawSize);
+			} else {
+				uLongf targetSize = static_cast<uLongf>(entry.rawSize);
+				if(uncompress(target, &targetSize, reinterpret_cast<const Bytef*>(&inputData[entry.offset]), static_cast<uLong>(entry.compressedSize)) != Z_OK || targetSize != entry.rawSize) {
+					throw block_compression_error("Failed to decompress block " + std::to_string(blockIndex) + "!");
+				}
+			}
+			if(static_cast<uint32_t>(crc32(0L, target, static_cast<uInt>(entry.rawSize))) != entry.checksum) {
+				throw block_compression_error("Checksum mismatch in block " + std::to_string(blockIndex) + "!");
+			}
+		});
+	} catch(...) {
+		delete[] outputData;
+		throw;
+	}
+	return outputData;
+}
+
+bool BlockDecompressor::isBlockCompressed(const int8_t* inputData, uint64_t inputSize) {
+	if(inputSize < BLOCK_COMPRESSION_HEADER_SIZE + BLOCK_COMPRESSION_FOOTER_SIZE) {
+		return false;
+	}
+	return readLittleEndian(&inputData[0], 4) == BLOCK_COMPRESSION_MAGIC && readLittleEndian(&inputData[inputSize - BLOCK_COMPRESSION_FOOTER_SIZE + 16], 4) == BLOCK_COMPRESSION_MAGIC;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+//Container of independently compressed blocks:
+//[header: magic, version, block size][block 0]...[block n-1][index: offset, compressed size, raw size, crc32 and flags per block][footer: index offset, block count, magic]
+//All numbers are little endian
+constexpr uint32_t BLOCK_COMPRESSION_MAGIC = 0x4B4C4250;	//"PBLK"
+constexpr uint32_t BLOCK_COMPRESSION_VERSION = 1;
+constexpr uint32_t BLOCK_COMPRESSION_DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+constexpr uint32_t BLOCK_COMPRESSION_STORE_ONLY = 0;		//Compression level which stores the blocks uncompressed
+constexpr uint64_t BLOCK_COMPRESSION_HEADER_SIZE = 16;
+constexpr uint64_t BLOCK_COMPRESSION_FOOTER_SIZE = 24;
+
+namespace AEX {
+
+	class block_compression_error : public std::runtime_error {
+		private:
+		protected:
+		public:
+			explicit block_compression_error(const std::string& message);
+	};
+
+	class BlockCompressor {
+		private:
+			uint32_t level;
+			uint32_t numOfThreads;
+			uint32_t blockSize;
+		protected:
+		public:
+			//Level 0 stores the blocks, 1 to 9 deflates them. 0 threads uses one thread per hardware thread
+			explicit BlockCompressor(uint32_t level = 6, uint32_t numOfThreads = 0, uint32_t blockSize = BLOCK_COMPRESSION_DEFAULT_BLOCK_SIZE);
+			int8_t* compress(int8_t* inputData, uint64_t inputSize, uint64_t& outputSize);
+	};
+
+	class BlockDecompressor {
+		private:
+			uint32_t numOfThreads;
+		protected:
+		public:
+			explicit BlockDecompressor(uint32_t numOfThreads = 0);
+			//Verifies the checksum of every block
+			int8_t* decompress(int8_t* inputData, uint64_t inputSize, uint64_t& outputSize);
+
+			static bool isBlockCompressed(const int8_t* inputData, uint64_t inputSize);
+	};
+}
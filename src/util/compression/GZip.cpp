@@ -65,6 +65,61 @@ int8_t* GZipCompressor::compress(int8_t* inputData, uint64_t inputSize, uint64_t
 	return outputBuffer.extractAndClear();
 }
 
+//############################ GZipOutputSink ############################
+
+void GZipOutputSink::deflateInput(int flush) {
+	do {
+		stream.avail_out = ZLIB_CHUNK_SIZE;
+		stream.next_out = reinterpret_cast<Bytef*>(outputBuffer);
+		if(deflate(&stream, flush) == Z_STREAM_ERROR) {
+			throw gzip_error("Error while deflating a chunck!");
+		}
+		sink->write(outputBuffer, ZLIB_CHUNK_SIZE - stream.avail_out);
+	} while(stream.avail_out == 0);
+}
+
+GZipOutputSink::GZipOutputSink(OutputSink* sink, uint32_t level) : sink(sink), finished(false), stream(), outputBuffer(new int8_t[ZLIB_CHUNK_SIZE]) {
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	if(level < 1 || level > 9) {
+		level = 9;
+	}
+	if(deflateInit2(&stream, level, Z_DEFLATED, 31, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+		delete[] outputBuffer;
+		throw gzip_error("Failed to initilize the deflator!");
+	}
+}
+
+GZipOutputSink::~GZipOutputSink() {
+	deflateEnd(&stream);
+	delete[] outputBuffer;
+}
+
+void GZipOutputSink::write(const int8_t* data, uint64_t size) {
+	if(finished) {
+		throw gzip_error("Sink has already finished!");
+	}
+	for(uint64_t i = 0;i < size;i += ZLIB_CHUNK_SIZE) {
+		uint64_t remainingBytes = size - i;
+		stream.avail_in = static_cast<uInt>((remainingBytes > ZLIB_CHUNK_SIZE) ? ZLIB_CHUNK_SIZE : remainingBytes);
+		stream.next_in = reinterpret_cast<Bytef*>(const_cast<int8_t*>(&data[i]));
+		deflateInput(Z_NO_FLUSH);
+	}
+}
+
+void GZipOutputSink::finish() {
+	if(finished) {
+		return;
+	}
+	finished = true;
+	Bytef inputDecoy;
+	stream.avail_in = 0;
+	stream.next_in = &inputDecoy;
+	deflateInput(Z_FINISH);
+	sink->finish();
+}
+
 //############################ GZipDecompressor ############################
 
 GZipDecompressor::GZipDecompressor() : stream() {
@@ -104,4 +159,47 @@ int8_t* GZipDecompressor::decompress(int8_t* inputData, uint64_t inputSize, uint
 	}
 	outputSize = outputBuffer.size();
 	return outputBuffer.extractAndClear();
+}
+
+//############################ GZipInputSource ############################
+
+GZipInputSource::GZipInputSource(InputSource* source) : source(source), finished(false), stream(), inputBuffer(new int8_t[ZLIB_CHUNK_SIZE]) {
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	stream.avail_in = 0;
+	stream.next_in = Z_NULL;
+	if(inflateInit2(&stream, 31) != Z_OK) {
+		delete[] inputBuffer;
+		throw gzip_error("Failed to initilize the inflater!");
+	}
+}
+
+GZipInputSource::~GZipInputSource() {
+	inflateEnd(&stream);
+	delete[] inputBuffer;
+}
+
+uint64_t GZipInputSource::read(int8_t* buffer, uint64_t size) {
+	uint64_t outputSize = 0;
+	while(!finished && outputSize < size) {
+		if(stream.avail_in == 0) {
+			stream.avail_in = static_cast<uInt>(source->read(inputBuffer, ZLIB_CHUNK_SIZE));
+			stream.next_in = reinterpret_cast<Bytef*>(inputBuffer);
+			if(stream.avail_in == 0) {
+				throw gzip_error("Unexpected end of the gzip stream!");
+			}
+		}
+		uint64_t remainingBytes = size - outputSize;
+		stream.avail_out = static_cast<uInt>((remainingBytes > ZLIB_CHUNK_SIZE) ? ZLIB_CHUNK_SIZE : remainingBytes);
+		stream.next_out = reinterpret_cast<Bytef*>(&buffer[outputSize]);
+		uInt availableOutput = stream.avail_out;
+		int result = inflate(&stream, Z_NO_FLUSH);
+		if(result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+			throw gzip_error("Error while inflating a chunck!");
+		}
+		outputSize += availableOutput - stream.avail_out;
+		finished = (result == Z_STREAM_END);
+	}
+	return outputSize;
 }
\ No newline at end of file
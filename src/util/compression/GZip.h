@@ -4,6 +4,7 @@
 #include <string>
 #include <stdexcept>
 #include <zlib/zlib.h>
+#include "../Streams.h"
 
 constexpr uint64_t ZLIB_CHUNK_SIZE = 16384;
 
@@ -28,6 +29,24 @@ namespace AEX {
 			int8_t* compress(int8_t* inputData, uint64_t inputSize, uint64_t& outputSize);
 	};
 
+	//Compresses everything written into a gzip stream, which is written to "sink" chunk by chunk. Does not take ownership of the sink
+	class GZipOutputSink : public OutputSink {
+		private:
+			OutputSink* sink;
+			bool finished;
+			z_stream stream;
+			int8_t* outputBuffer;
+
+			void deflateInput(int flush);
+		protected:
+		public:
+			explicit GZipOutputSink(OutputSink* sink, uint32_t level = 9);
+			~GZipOutputSink() override;
+			void write(const int8_t* data, uint64_t size) override;
+			//Finishes the gzip stream and the underlying sink
+			void finish() override;
+	};
+
 	class GZipDecompressor {
 		private:
 			z_stream stream;
@@ -37,4 +56,18 @@ namespace AEX {
 			~GZipDecompressor();
 			int8_t* decompress(int8_t* inputData, uint64_t inputSize, uint64_t& outputSize);
 	};
+
+	//Decompresses a gzip stream read from "source" chunk by chunk. Does not take ownership of the source
+	class GZipInputSource : public InputSource {
+		private:
+			InputSource* source;
+			bool finished;
+			z_stream stream;
+			int8_t* inputBuffer;
+		protected:
+		public:
+			explicit GZipInputSource(InputSource* source);
+			~GZipInputSource() override;
+			uint64_t read(int8_t* buffer, uint64_t size) override;
+	};
 }
\ No newline at end of file
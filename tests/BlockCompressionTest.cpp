@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <memory>
+
+#include "../src/util/compression/BlockCompression.h"
+
+using namespace AEX;
+
+//############################ Helpers ############################
+
+// Compressible data: repeating pattern with some noise. 
+static std::vector<int8_t> makeData(size_t size, uint32_t seed) {
+	std::vector<int8_t> data = std::vector<int8_t>(size);
+	uint32_t state = seed;
+	for(size_t i = 0; i < size; i++) {
+		state = state * 1664525U + 1013904223U;
+		data[i] = static_cast<int8_t>((i % 64) + ((state >> 24) & 3));
+	}
+	return data;
+}
+
+static std::vector<int8_t> compress(std::vector<int8_t>& data, uint32_t level, uint32_t numOfThreads, uint32_t blockSize) {
+	uint64_t compressedSize = 0;
+	std::unique_ptr<int8_t[]> compressedData = std::unique_ptr<int8_t[]>(BlockCompressor(level, numOfThreads, blockSize).compress(data.data(), data.size(), compressedSize));
+	return std::vector<int8_t>(compressedData.get(), compressedData.get() + compressedSize);
+}
+
+static std::vector<int8_t> decompress(std::vector<int8_t>& compressedData, uint32_t numOfThreads) {
+	uint64_t rawSize = 0;
+	std::unique_ptr<int8_t[]> rawData = std::unique_ptr<int8_t[]>(BlockDecompressor(numOfThreads).decompress(compressedData.data(), compressedData.size(), rawSize));
+	return std::vector<int8_t>(rawData.get(), rawData.get() + rawSize);
+}
+
+//############################ BlockCompression ############################
+
+TEST(BlockCompression, RoundTripLevels) {
+	std::vector<int8_t> data = makeData(100000, 1);
+	for(uint32_t level : { BLOCK_COMPRESSION_STORE_ONLY, 1U, 6U, 9U }) {
+		std::vector<int8_t> compressedData = compress(data, level, 2, 4096);
+		EXPECT_TRUE(BlockDecompressor::isBlockCompressed(compressedData.data(), compressedData.size())) << "level " << level;
+		if(level != BLOCK_COMPRESSION_STORE_ONLY) {
+			EXPECT_LT(compressedData.size(), data.size()) << "level " << level;
+		}
+		EXPECT_EQ(decompress(compressedData, 3), data) << "level " << level;
+	}
+}
+
+TEST(BlockCompression, RoundTripBlockBoundaries) {
+	// Sizes below, at and above multiples of the block size, decompressed with other thread counts than used for compressing. 
+	for(size_t size : { static_cast<size_t>(1), static_cast<size_t>(1023), static_cast<size_t>(1024), static_cast<size_t>(1025), static_cast<size_t>(10 * 1024) }) {
+		std::vector<int8_t> data = makeData(size, static_cast<uint32_t>(size));
+		std::vector<int8_t> compressedData = compress(data, 6, 4, 1024);
+		EXPECT_EQ(decompress(compressedData, 1), data) << "size " << size;
+		EXPECT_EQ(decompress(compressedData, 0), data) << "size " << size;
+	}
+}
+
+TEST(BlockCompression, IncompressibleBlocksAreStored) {
+	std::vector<int8_t> data = std::vector<int8_t>(4096);
+	uint32_t state = 7;
+	for(int8_t& value : data) {
+		state = state * 1664525U + 1013904223U;
+		value = static_cast<int8_t>(state >> 24);
+	}
+	std::vector<int8_t> compressedData = compress(data, 9, 1, 1024);
+	EXPECT_EQ(compressedData.size(), BLOCK_COMPRESSION_HEADER_SIZE + data.size() + 4 * 32 + BLOCK_COMPRESSION_FOOTER_SIZE);
+	EXPECT_EQ(decompress(compressedData, 2), data);
+}
+
+TEST(BlockCompression, DetectsCorruptedBlock) {
+	std::vector<int8_t> data = makeData(8192, 2);
+	for(uint32_t level : { BLOCK_COMPRESSION_STORE_ONLY, 6U }) {
+		std::vector<int8_t> compressedData = compress(data, level, 2, 1024);
+		// Flip a bit in the first block, the checksum (or the inflate of a deflated block) has to fail. 
+		compressedData[BLOCK_COMPRESSION_HEADER_SIZE + 3] ^= 0x10;
+		EXPECT_THROW(decompress(compressedData, 2), block_compression_error) << "level " << level;
+	}
+}
+
+TEST(BlockCompression, DetectsTruncatedData) {
+	std::vector<int8_t> data = makeData(8192, 3);
+	std::vector<int8_t> compressedData = compress(data, 6, 2, 1024);
+	compressedData.resize(compressedData.size() - 5);
+	EXPECT_FALSE(BlockDecompressor::isBlockCompressed(compressedData.data(), compressedData.size()));
+	EXPECT_THROW(decompress(compressedData, 2), block_compression_error);
+}
+
+TEST(BlockCompression, RejectsOtherData) {
+	std::vector<int8_t> data = makeData(256, 4);
+	EXPECT_FALSE(BlockDecompressor::isBlockCompressed(data.data(), data.size()));
+	EXPECT_THROW(decompress(data, 1), block_compression_error);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <filesystem>
+
+#include "../src/trainingController/CheckpointIndex.h"
+
+using namespace PLANS;
+
+//############################ Fixture ############################
+
+// Fresh directory with dummy checkpoint files per test. 
+class CheckpointIndexTest : public ::testing::Test {
+	protected:
+		std::filesystem::path directory;
+
+		void SetUp() override {
+			directory = std::filesystem::temp_directory_path() / ("CheckpointIndexTest_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory);
+		}
+
+		void TearDown() override {
+			std::filesystem::remove_all(directory);
+		}
+
+		std::string getFileName(uint32_t episode) const {
+			return "model_episode" + std::to_string(episode) + CHECKPOINT_FILE_EXTENSION;
+		}
+
+		// Creates the file and adds it to the index. 
+		void addCheckpoint(CheckpointIndex& index, uint32_t episode, const std::string& baseFileName = "") {
+			std::string fileName = getFileName(episode);
+			std::ofstream(directory / fileName) << "checkpoint";
+			index.add(fileName, episode, 10, baseFileName);
+		}
+
+		bool exists(uint32_t episode) const {
+			return std::filesystem::exists(directory / getFileName(episode));
+		}
+
+		std::vector<uint32_t> getEpisodes(const CheckpointIndex& index) const {
+			std::vector<uint32_t> episodes;
+			for(const CheckpointIndexEntry& entry : index.getEntries()) {
+				episodes.push_back(entry.episode);
+			}
+			return episodes;
+		}
+};
+
+//############################ CheckpointIndex ############################
+
+TEST_F(CheckpointIndexTest, KeepsLastAndEvery) {
+	CheckpointIndex index = CheckpointIndex(directory.u8string(), "model", 2, 100);
+	for(uint32_t episode = 50; episode <= 350; episode += 50) {
+		addCheckpoint(index, episode);
+	}
+	index.applyRetention();
+	EXPECT_EQ(getEpisodes(index), std::vector<uint32_t>({ 100, 200, 300, 350 }));
+	EXPECT_FALSE(exists(50));
+	EXPECT_TRUE(exists(100));
+	EXPECT_FALSE(exists(150));
+	EXPECT_TRUE(exists(200));
+	EXPECT_FALSE(exists(250));
+	EXPECT_TRUE(exists(300));
+	EXPECT_TRUE(exists(350));
+}
+
+TEST_F(CheckpointIndexTest, KeepLastZeroKeepsAll) {
+	CheckpointIndex index = CheckpointIndex(directory.u8string(), "model", 0, 0);
+	for(uint32_t episode = 1; episode <= 5; episode++) {
+		addCheckpoint(index, episode);
+	}
+	index.applyRetention();
+	EXPECT_EQ(getEpisodes(index), std::vector<uint32_t>({ 1, 2, 3, 4, 5 }));
+	for(uint32_t episode = 1; episode <= 5; episode++) {
+		EXPECT_TRUE(exists(episode));
+	}
+}
+
+TEST_F(CheckpointIndexTest, KeepEveryZeroKeepsOnlyLast) {
+	CheckpointIndex index = CheckpointIndex(directory.u8string(), "model", 1, 0);
+	for(uint32_t episode = 10; episode <= 40; episode += 10) {
+		addCheckpoint(index, episode);
+	}
+	index.applyRetention();
+	EXPECT_EQ(getEpisodes(index), std::vector<uint32_t>({ 40 }));
+	EXPECT_FALSE(exists(10));
+	EXPECT_TRUE(exists(40));
+}
+
+TEST_F(CheckpointIndexTest, KeepsBasesOfRetainedDeltas) {
+	// 10 is a full checkpoint, 20 to 40 are deltas on it. Only the last delta is retained, but its base has to stay. 
+	CheckpointIndex index = CheckpointIndex(directory.u8string(), "model", 1, 0);
+	addCheckpoint(index, 10);
+	addCheckpoint(index, 20, getFileName(10));
+	addCheckpoint(index, 30, getFileName(10));
+	addCheckpoint(index, 40, getFileName(10));
+	index.applyRetention();
+	EXPECT_EQ(getEpisodes(index), std::vector<uint32_t>({ 10, 40 }));
+	EXPECT_TRUE(exists(10));
+	EXPECT_FALSE(exists(20));
+	EXPECT_FALSE(exists(30));
+	EXPECT_TRUE(exists(40));
+}
+
+TEST_F(CheckpointIndexTest, MissingFilesAreDropped) {
+	// Removing a file which is already gone isn't an error, so the entry is dropped. 
+	CheckpointIndex index = CheckpointIndex(directory.u8string(), "model", 1, 0);
+	addCheckpoint(index, 1);
+	addCheckpoint(index, 2);
+	std::filesystem::remove(directory / getFileName(1));
+	index.applyRetention();
+	EXPECT_EQ(getEpisodes(index), std::vector<uint32_t>({ 2 }));
+}
+
+TEST_F(CheckpointIndexTest, SaveLoadAndRebuild) {
+	CheckpointIndex index = CheckpointIndex(directory.u8string(), "model", 0, 0);
+	addCheckpoint(index, 30);
+	addCheckpoint(index, 10);
+	addCheckpoint(index, 20, getFileName(10));
+	index.save();
+
+	CheckpointIndex loadedIndex = CheckpointIndex(directory.u8string(), "model", 0, 0);
+	ASSERT_TRUE(loadedIndex.load());
+	EXPECT_EQ(getEpisodes(loadedIndex), std::vector<uint32_t>({ 10, 20, 30 }));
+	EXPECT_EQ(loadedIndex.getEntries()[1].baseFileName, getFileName(10));
+	ASSERT_NE(loadedIndex.getLatest(), nullptr);
+	EXPECT_EQ(loadedIndex.getLatest()->episode, 30U);
+
+	// The dummy files aren't delta checkpoints, so the rebuilt entries have no base. Files of other models are ignored. 
+	std::ofstream(directory / ("other_episode5" + CHECKPOINT_FILE_EXTENSION)) << "checkpoint";
+	CheckpointIndex rebuiltIndex = CheckpointIndex(directory.u8string(), "model", 0, 0);
+	rebuiltIndex.rebuild();
+	EXPECT_EQ(getEpisodes(rebuiltIndex), std::vector<uint32_t>({ 10, 20, 30 }));
+	EXPECT_TRUE(rebuiltIndex.getEntries()[1].baseFileName.empty());
+}
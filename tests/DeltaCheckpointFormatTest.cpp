@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+#include <filesystem>
+
+#include "../src/trainingController/DeltaCheckpointFormat.h"
+#include "../src/util/Serialization.h"
+#include "../src/util/Streams.h"
+
+using namespace PLANS;
+using namespace AEX;
+
+//############################ Helpers ############################
+
+static std::vector<float> makeWeights(size_t count, uint32_t seed) {
+	std::vector<float> weights = std::vector<float>(count);
+	uint32_t state = seed;
+	for(size_t i = 0; i < count; i++) {
+		state = state * 1664525U + 1013904223U;
+		weights[i] = static_cast<float>(state >> 8) / static_cast<float>(1U << 23) - 1.0F;
+	}
+	return weights;
+}
+
+//############################ DeltaCheckpointFormat ############################
+
+TEST(DeltaCheckpointFormat, RoundTripFloats) {
+	std::vector<float> base = makeWeights(1001, 1);
+	std::vector<float> source = base;
+	for(size_t i = 0; i < source.size(); i += 3) {
+		source[i] += 1e-4F;
+	}
+	std::vector<int8_t> encoded = std::vector<int8_t>(source.size() * sizeof(float));
+	std::vector<float> decoded = std::vector<float>(source.size());
+	DeltaCheckpointFormat::encode(reinterpret_cast<const int8_t*>(source.data()), reinterpret_cast<const int8_t*>(base.data()), encoded.data(), source.size(), sizeof(float));
+	DeltaCheckpointFormat::decode(encoded.data(), reinterpret_cast<const int8_t*>(base.data()), reinterpret_cast<int8_t*>(decoded.data()), source.size(), sizeof(float));
+	EXPECT_EQ(std::memcmp(decoded.data(), source.data(), source.size() * sizeof(float)), 0);
+}
+
+TEST(DeltaCheckpointFormat, RoundTripElementSizes) {
+	for(uint32_t elementSize : { 1U, 2U, 4U, 8U }) {
+		size_t numOfElements = 37;
+		std::vector<float> randomBytes = makeWeights(numOfElements * 2, elementSize);
+		const int8_t* source = reinterpret_cast<const int8_t*>(randomBytes.data());
+		const int8_t* base = source + numOfElements;
+		std::vector<int8_t> encoded = std::vector<int8_t>(numOfElements * elementSize);
+		std::vector<int8_t> decoded = std::vector<int8_t>(numOfElements * elementSize);
+		DeltaCheckpointFormat::encode(source, base, encoded.data(), numOfElements, elementSize);
+		DeltaCheckpointFormat::decode(encoded.data(), base, decoded.data(), numOfElements, elementSize);
+		EXPECT_EQ(std::memcmp(decoded.data(), source, decoded.size()), 0) << "element size " << elementSize;
+	}
+}
+
+TEST(DeltaCheckpointFormat, GroupsBytesByPosition) {
+	// Unchanged elements encode to zeros, the bytes of a changed element end up in separate planes. 
+	std::vector<uint32_t> base = { 0x11223344U, 0x55667788U, 0x99AABBCCU };
+	std::vector<uint32_t> source = { 0x11223344U, 0x55667789U, 0x99AABBCCU };
+	std::vector<int8_t> encoded = std::vector<int8_t>(base.size() * sizeof(uint32_t), -1);
+	DeltaCheckpointFormat::encode(reinterpret_cast<const int8_t*>(source.data()), reinterpret_cast<const int8_t*>(base.data()), encoded.data(), base.size(), sizeof(uint32_t));
+	std::vector<int8_t> expected = std::vector<int8_t>(encoded.size(), 0);
+	// Plane of the least significant bytes on little endian, element 1. 
+	expected[1] = 0x01;
+	EXPECT_EQ(encoded, expected);
+}
+
+TEST(DeltaCheckpointFormat, GetBaseFileName) {
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "DeltaCheckpointFormatTest";
+	std::filesystem::create_directories(directory);
+	std::string deltaFilePath = (directory / "delta.checkpoint").u8string();
+	std::string otherFilePath = (directory / "other.checkpoint").u8string();
+	{
+		FileOutputSink sink(deltaFilePath, true);
+		Serializer serializer = Serializer(&sink);
+		serializer.serialize(DELTA_CHECKPOINT_MAGIC);
+		serializer.serialize(DELTA_CHECKPOINT_VERSION);
+		serializer.serialize(std::string("model_episode100.checkpoint"));
+		serializer.finish();
+	}
+	{
+		FileOutputSink sink(otherFilePath, true);
+		Serializer serializer = Serializer(&sink);
+		serializer.serialize(static_cast<uint32_t>(0x12345678U));
+		serializer.serialize(static_cast<uint64_t>(0));
+		serializer.finish();
+	}
+	EXPECT_EQ(DeltaCheckpointFormat::getBaseFileName(deltaFilePath), "model_episode100.checkpoint");
+	EXPECT_EQ(DeltaCheckpointFormat::getBaseFileName(otherFilePath), "");
+	EXPECT_EQ(DeltaCheckpointFormat::getBaseFileName((directory / "missing.checkpoint").u8string()), "");
+	std::filesystem::remove_all(directory);
+}
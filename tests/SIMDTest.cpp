@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../src/util/SIMD.h"
+
+using namespace AEX;
+
+//############################ Reference ############################
+
+static double referenceDot(const std::vector<float>& a, const std::vector<float>& b, uint32_t length) {
+	double sum = 0.0;
+	for(uint32_t i = 0; i < length; i++) {
+		sum += static_cast<double>(a[i]) * b[i];
+	}
+	return sum;
+}
+
+static std::vector<float> makeValues(size_t count, uint32_t seed) {
+	std::vector<float> values = std::vector<float>(count);
+	uint32_t state = seed;
+	for(size_t i = 0; i < count; i++) {
+		state = state * 1664525U + 1013904223U;
+		values[i] = static_cast<float>(state >> 8) / static_cast<float>(1U << 23) - 1.0F;
+	}
+	return values;
+}
+
+//############################ SIMD ############################
+
+TEST(SIMD, DotMatchesReferenceOnAllLevels) {
+	// Unaligned start (offset 1) and the row lengths FastActorCritic uses (multiples of 8). 
+	std::vector<float> a = makeValues(257, 1);
+	std::vector<float> b = makeValues(257, 2);
+	std::vector<float> shiftedA = std::vector<float>(a.begin() + 1, a.end());
+	std::vector<float> shiftedB = std::vector<float>(b.begin() + 1, b.end());
+	for(SIMDLevel level : { SIMDLevel::SCALAR, SIMDLevel::SSE, SIMDLevel::AVX2 }) {
+		if(level > SIMD::getDetectedLevel()) {
+			continue;	// Not supported by this CPU. 
+		}
+		for(uint32_t length : { 0U, 8U, 16U, 64U, 256U }) {
+			EXPECT_NEAR(SIMD::dot(level, a.data(), b.data(), length), referenceDot(a, b, length), 1e-4) << "level " << static_cast<int>(level) << ", length " << length;
+			EXPECT_NEAR(SIMD::dot(level, a.data() + 1, b.data() + 1, length), referenceDot(shiftedA, shiftedB, length), 1e-4) << "level " << static_cast<int>(level) << ", length " << length;
+		}
+	}
+}
+
+TEST(SIMD, DotOfZeroPaddingIsExact) {
+	// The padded tail of a row (zeros) mustn't change the result. 
+	std::vector<float> a = { 1.0F, 2.0F, 3.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F };
+	std::vector<float> b = { 4.0F, -5.0F, 0.5F, 7.0F, 8.0F, 9.0F, 10.0F, 11.0F };
+	for(SIMDLevel level : { SIMDLevel::SCALAR, SIMDLevel::SSE, SIMDLevel::AVX2 }) {
+		if(level > SIMD::getDetectedLevel()) {
+			continue;
+		}
+		EXPECT_FLOAT_EQ(SIMD::dot(level, a.data(), b.data(), 8), -4.5F) << "level " << static_cast<int>(level);
+	}
+}
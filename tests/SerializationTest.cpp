@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../src/util/Serialization.h"
+#include "../src/util/Streams.h"
+
+using namespace AEX;
+
+//############################ Helpers ############################
+
+// Writes one value of every supported type, a string, raw bytes and arrays. 
+static void serializeSample(Serializer& serializer) {
+	serializer.serialize(static_cast<uint8_t>(200));
+	serializer.serialize(static_cast<int8_t>(-100));
+	serializer.serialize(static_cast<uint16_t>(60000));
+	serializer.serialize(static_cast<int16_t>(-30000));
+	serializer.serialize(static_cast<uint32_t>(4000000000U));
+	serializer.serialize(static_cast<int32_t>(-2000000000));
+	serializer.serialize(static_cast<uint64_t>(1ULL << 60));
+	serializer.serialize(static_cast<int64_t>(-(1LL << 60)));
+	serializer.serialize(1.5F);
+	serializer.serialize(-2.25);
+	serializer.serialize(true);
+	serializer.serialize(std::string("checkpoint"));
+	int8_t bytes[5] = { 1, -2, 3, -4, 5 };
+	serializer.serialize(bytes, 5);
+	std::vector<float> floats = { 0.5F, -1.0F, 3.25F };
+	serializer.serialize(floats);
+	std::vector<int64_t> empty;
+	serializer.serialize(empty);
+}
+
+static void expectSample(Deserializer& deserializer) {
+	uint8_t u8 = 0;
+	int8_t i8 = 0;
+	uint16_t u16 = 0;
+	int16_t i16 = 0;
+	uint32_t u32 = 0;
+	int32_t i32 = 0;
+	uint64_t u64 = 0;
+	int64_t i64 = 0;
+	float f = 0.0F;
+	double d = 0.0;
+	bool b = false;
+	std::string s;
+	int8_t* bytes = nullptr;
+	std::vector<float> floats;
+	std::vector<int64_t> empty = { 7 };
+	deserializer.deserialize(u8);
+	deserializer.deserialize(i8);
+	deserializer.deserialize(u16);
+	deserializer.deserialize(i16);
+	deserializer.deserialize(u32);
+	deserializer.deserialize(i32);
+	deserializer.deserialize(u64);
+	deserializer.deserialize(i64);
+	deserializer.deserialize(f);
+	deserializer.deserialize(d);
+	deserializer.deserialize(b);
+	deserializer.deserialize(s);
+	EXPECT_EQ(u8, 200);
+	EXPECT_EQ(i8, -100);
+	EXPECT_EQ(u16, 60000);
+	EXPECT_EQ(i16, -30000);
+	EXPECT_EQ(u32, 4000000000U);
+	EXPECT_EQ(i32, -2000000000);
+	EXPECT_EQ(u64, 1ULL << 60);
+	EXPECT_EQ(i64, -(1LL << 60));
+	EXPECT_FLOAT_EQ(f, 1.5F);
+	EXPECT_DOUBLE_EQ(d, -2.25);
+	EXPECT_TRUE(b);
+	EXPECT_EQ(s, "checkpoint");
+	// The raw bytes are only valid until the next call in streaming mode. 
+	deserializer.deserialize(bytes, 5);
+	EXPECT_EQ(std::vector<int8_t>(bytes, bytes + 5), std::vector<int8_t>({ 1, -2, 3, -4, 5 }));
+	deserializer.deserialize(floats);
+	EXPECT_EQ(floats, std::vector<float>({ 0.5F, -1.0F, 3.25F }));
+	deserializer.deserialize(empty);
+	EXPECT_TRUE(empty.empty());
+}
+
+//############################ Serialization ############################
+
+TEST(Serialization, BufferRoundTrip) {
+	Serializer serializer = Serializer();
+	serializeSample(serializer);
+	Deserializer deserializer = Deserializer(serializer.getSerializedData(), serializer.getDataLength());
+	expectSample(deserializer);
+	EXPECT_EQ(deserializer.getCurrentOffset(), serializer.getDataLength());
+}
+
+TEST(Serialization, StreamingMatchesBuffer) {
+	Serializer bufferSerializer = Serializer();
+	serializeSample(bufferSerializer);
+
+	// A tiny buffer forces flushes within values and arrays. 
+	MemoryOutputSink sink = MemoryOutputSink();
+	Serializer streamSerializer = Serializer(&sink, 3);
+	serializeSample(streamSerializer);
+	streamSerializer.finish();
+	ASSERT_EQ(sink.getDataLength(), bufferSerializer.getDataLength());
+	EXPECT_EQ(std::vector<int8_t>(sink.getData(), sink.getData() + sink.getDataLength()), std::vector<int8_t>(bufferSerializer.getSerializedData(), bufferSerializer.getSerializedData() + bufferSerializer.getDataLength()));
+
+	MemoryInputSource source = MemoryInputSource(sink.getData(), sink.getDataLength());
+	Deserializer streamDeserializer = Deserializer(&source, 3);
+	expectSample(streamDeserializer);
+}
+
+TEST(Serialization, LargeArrayRoundTrip) {
+	std::vector<double> values = std::vector<double>(100000);
+	for(size_t i = 0; i < values.size(); i++) {
+		values[i] = static_cast<double>(i) * 0.5 - 1000.0;
+	}
+	MemoryOutputSink sink = MemoryOutputSink();
+	Serializer serializer = Serializer(&sink, 4096);
+	serializer.serializeArray(values.data(), values.size());
+	serializer.finish();
+	ASSERT_EQ(sink.getDataLength(), values.size() * sizeof(double));
+
+	MemoryInputSource source = MemoryInputSource(sink.getData(), sink.getDataLength());
+	Deserializer deserializer = Deserializer(&source, 4096);
+	std::vector<double> result = std::vector<double>(values.size());
+	deserializer.deserializeArray(result.data(), result.size());
+	EXPECT_EQ(result, values);
+}
+
+TEST(Serialization, ReadingPastTheEndThrows) {
+	Serializer serializer = Serializer();
+	serializer.serialize(static_cast<uint16_t>(1));
+	Deserializer deserializer = Deserializer(serializer.getSerializedData(), serializer.getDataLength());
+	uint32_t value = 0;
+	EXPECT_THROW(deserializer.deserialize(value), serialization_error);
+}
+
+TEST(Serialization, LimitThrows) {
+	Serializer serializer = Serializer(4);
+	serializer.serialize(static_cast<uint32_t>(1));
+	EXPECT_THROW(serializer.serialize(static_cast<uint8_t>(1)), serialization_error);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include "../src/TrainingGAE.h"
+
+using namespace PLANS;
+
+//############################ Reference ############################
+
+// Replica of the tensor based loop "TrainingGAE::computeReturns" replaced (one environment, float32 arithmetic with float scalars). 
+static std::vector<float> referenceReturns(const std::vector<float>& rewards, const std::vector<float>& values, double gamma, double lambda) {
+	float gae = 0.0F;
+	std::vector<float> returns = std::vector<float>(rewards.size(), 0.0F);
+	for(size_t i = rewards.size() - 1; i > 0; i--) {
+		float delta = rewards[i] + static_cast<float>(gamma) * values[i - 1] - values[i];
+		gae = delta + static_cast<float>(gamma * lambda) * gae;
+		returns[i] = gae + values[i];
+	}
+	return returns;
+}
+
+// Deterministic pseudo random values in [-1, 1). 
+static std::vector<float> makeValues(size_t count, uint32_t seed) {
+	std::vector<float> values = std::vector<float>(count);
+	uint32_t state = seed;
+	for(size_t i = 0; i < count; i++) {
+		state = state * 1664525U + 1013904223U;
+		values[i] = static_cast<float>(state >> 8) / static_cast<float>(1U << 23) - 1.0F;
+	}
+	return values;
+}
+
+// Runs the kernel on time-major data of "numOfEnvironments" environments and compares every environment with the reference. 
+static void expectMatchesReference(uint32_t numOfSteps, uint32_t numOfEnvironments, double gamma, double lambda) {
+	size_t count = static_cast<size_t>(numOfSteps) * numOfEnvironments;
+	std::vector<float> rewards = makeValues(count, 1);
+	std::vector<float> values = makeValues(count, 2);
+	std::vector<float> returns = std::vector<float>(count, -1.0F);
+	std::vector<float> advantages = std::vector<float>(count, -1.0F);
+	TrainingGAE::computeReturns(rewards.data(), values.data(), numOfSteps, numOfEnvironments, gamma, lambda, returns.data(), advantages.data());
+
+	std::vector<float> environmentRewards = std::vector<float>(numOfSteps);
+	std::vector<float> environmentValues = std::vector<float>(numOfSteps);
+	for(uint32_t e = 0; e < numOfEnvironments; e++) {
+		for(uint32_t i = 0; i < numOfSteps; i++) {
+			environmentRewards[i] = rewards[static_cast<size_t>(i) * numOfEnvironments + e];
+			environmentValues[i] = values[static_cast<size_t>(i) * numOfEnvironments + e];
+		}
+		std::vector<float> expected = referenceReturns(environmentRewards, environmentValues, gamma, lambda);
+		for(uint32_t i = 0; i < numOfSteps; i++) {
+			size_t index = static_cast<size_t>(i) * numOfEnvironments + e;
+			EXPECT_FLOAT_EQ(returns[index], expected[i]) << "step " << i << ", environment " << e;
+			EXPECT_FLOAT_EQ(advantages[index], expected[i] - values[index]) << "step " << i << ", environment " << e;
+		}
+	}
+}
+
+//############################ TrainingGAE ############################
+
+TEST(TrainingGAE, MatchesReferenceSingleEnvironment) {
+	expectMatchesReference(120, 1, 0.99, 0.95);
+}
+
+TEST(TrainingGAE, MatchesReferenceMultipleEnvironments) {
+	// The environments are interleaved per step, each one is scanned on its own. 
+	expectMatchesReference(57, 5, 0.99, 0.95);
+	expectMatchesReference(64, 32, 0.9, 0.8);
+}
+
+TEST(TrainingGAE, MatchesReferenceLambdaBounds) {
+	expectMatchesReference(40, 3, 0.99, 0.0);
+	expectMatchesReference(40, 3, 0.99, 1.0);
+}
+
+TEST(TrainingGAE, SingleStepReturnsZero) {
+	// The scan doesn't reach step 0, so its return is 0 and the advantage is the negative value. 
+	std::vector<float> rewards = { 1.0F, 2.0F };
+	std::vector<float> values = { 0.5F, -0.25F };
+	std::vector<float> returns = { -1.0F, -1.0F };
+	std::vector<float> advantages = { -1.0F, -1.0F };
+	TrainingGAE::computeReturns(rewards.data(), values.data(), 1, 2, 0.99, 0.95, returns.data(), advantages.data());
+	EXPECT_FLOAT_EQ(returns[0], 0.0F);
+	EXPECT_FLOAT_EQ(returns[1], 0.0F);
+	EXPECT_FLOAT_EQ(advantages[0], -0.5F);
+	EXPECT_FLOAT_EQ(advantages[1], 0.25F);
+}
+
+TEST(TrainingGAE, DeltaUsesPreviousValue) {
+	// gamma = 0.5, lambda = 0: return[i] = reward[i] + 0.5 * value[i - 1]. 
+	std::vector<float> rewards = { 10.0F, 1.0F, 2.0F };
+	std::vector<float> values = { 4.0F, 8.0F, 16.0F };
+	std::vector<float> returns = std::vector<float>(3, -1.0F);
+	TrainingGAE::computeReturns(rewards.data(), values.data(), 3, 1, 0.5, 0.0, returns.data());
+	EXPECT_FLOAT_EQ(returns[0], 0.0F);
+	EXPECT_FLOAT_EQ(returns[1], 3.0F);
+	EXPECT_FLOAT_EQ(returns[2], 6.0F);
+}
+
+TEST(TrainingGAE, NoStepsLeavesOutputUntouched) {
+	float returns = -1.0F;
+	TrainingGAE::computeReturns(nullptr, nullptr, 0, 4, 0.99, 0.95, &returns);
+	EXPECT_FLOAT_EQ(returns, -1.0F);
+}